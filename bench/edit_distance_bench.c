@@ -0,0 +1,338 @@
+#define _POSIX_C_SOURCE 200809L
+#include "edit_distance.c"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define AMS_BENCH_MAX_LENGTH 160
+#define AMS_BENCH_BATCH_SIZE 64
+#define AMS_BENCH_DEFAULT_ROUNDS 20000
+#define AMS_BENCH_TIMING_CALLS 200000
+
+typedef void (*BatchFunction)(
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count,
+    int *distances);
+
+static const size_t bench_lengths[] = {0, 1, 2, 7, 31, 32, 33, 63, 64, 65, 127, 128, 129};
+
+static uint64_t bench_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t bench_random(void);
+static size_t bench_length(void);
+static void bench_string(char *buffer, size_t length, size_t alphabet);
+static void bench_mutate(char *buffer, size_t *length, const char *source, size_t source_length, size_t edits);
+static int reference_distance(const char *left, size_t left_length, const char *right, size_t right_length);
+static int check_bounded(size_t rounds);
+static int check_batches(size_t rounds);
+static int check_batch(
+    const char *name,
+    BatchFunction batch,
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count);
+static double elapsed_ns(const struct timespec *start, const struct timespec *end);
+static void time_bounded(size_t length, int max_distance);
+static void time_batch(const char *name, BatchFunction batch, size_t query_length);
+
+int main(int argc, char **argv) {
+    size_t rounds = AMS_BENCH_DEFAULT_ROUNDS;
+    if (argc > 1) {
+        rounds = (size_t)strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        bench_state = strtoull(argv[2], NULL, 10) | 1;
+    }
+
+    int failures = check_bounded(rounds) + check_batches(rounds);
+    if (failures > 0) {
+        fprintf(stderr, "%d edit distance mismatches\n", failures);
+        return 1;
+    }
+    printf("edit distance paths agree with the scalar DP over %zu rounds\n", rounds);
+
+    time_bounded(16, 3);
+    time_bounded(64, 8);
+    time_bounded(128, 16);
+    time_batch("scalar", batch_scalar, 16);
+#ifdef AMS_EDIT_DISTANCE_X86
+    if (__builtin_cpu_supports("sse4.1")) {
+        time_batch("sse4.1", batch_sse41, 16);
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        time_batch("avx2", batch_avx2, 16);
+    }
+#endif
+    return 0;
+}
+
+static uint64_t bench_random(void) {
+    bench_state ^= bench_state << 13;
+    bench_state ^= bench_state >> 7;
+    bench_state ^= bench_state << 17;
+    return bench_state;
+}
+
+static size_t bench_length(void) {
+    size_t base = bench_lengths[bench_random() % (sizeof(bench_lengths) / sizeof(bench_lengths[0]))];
+    size_t jitter = (size_t)(bench_random() % 5);
+    size_t length = base + jitter >= 2 ? base + jitter - 2 : 0;
+    return length < AMS_BENCH_MAX_LENGTH ? length : AMS_BENCH_MAX_LENGTH - 1;
+}
+
+static void bench_string(char *buffer, size_t length, size_t alphabet) {
+    for (size_t i = 0; i < length; ++i) {
+        buffer[i] = (char)('A' + bench_random() % alphabet);
+    }
+    buffer[length] = '\0';
+}
+
+static void bench_mutate(char *buffer, size_t *length, const char *source, size_t source_length, size_t edits) {
+    memcpy(buffer, source, source_length + 1);
+    size_t current = source_length;
+    for (size_t e = 0; e < edits; ++e) {
+        size_t position = current > 0 ? (size_t)(bench_random() % (current + 1)) : 0;
+        unsigned operation = (unsigned)(bench_random() % 3);
+        if (operation == 0 && current + 1 < AMS_BENCH_MAX_LENGTH) {
+            memmove(buffer + position + 1, buffer + position, current - position + 1);
+            buffer[position] = (char)('A' + bench_random() % 4);
+            ++current;
+        } else if (operation == 1 && position < current) {
+            memmove(buffer + position, buffer + position + 1, current - position);
+            --current;
+        } else if (position < current) {
+            buffer[position] = (char)('A' + bench_random() % 4);
+        }
+    }
+    *length = current;
+}
+
+static int reference_distance(const char *left, size_t left_length, const char *right, size_t right_length) {
+    int rows[2][AMS_BENCH_MAX_LENGTH + 1];
+    int *prev = rows[0];
+    int *curr = rows[1];
+    for (size_t j = 0; j <= right_length; ++j) {
+        prev[j] = (int)j;
+    }
+    for (size_t i = 1; i <= left_length; ++i) {
+        curr[0] = (int)i;
+        for (size_t j = 1; j <= right_length; ++j) {
+            int cost = left[i - 1] == right[j - 1] ? 0 : 1;
+            int best = prev[j] + 1;
+            if (curr[j - 1] + 1 < best) {
+                best = curr[j - 1] + 1;
+            }
+            if (prev[j - 1] + cost < best) {
+                best = prev[j - 1] + cost;
+            }
+            curr[j] = best;
+        }
+        int *tmp = prev;
+        prev = curr;
+        curr = tmp;
+    }
+    return prev[right_length];
+}
+
+static int check_bounded(size_t rounds) {
+    char left[AMS_BENCH_MAX_LENGTH + 1];
+    char right[AMS_BENCH_MAX_LENGTH + 1];
+    int failures = 0;
+    for (size_t round = 0; round < rounds && failures < 10; ++round) {
+        size_t left_length = bench_length();
+        size_t right_length = 0;
+        size_t alphabet = 2 + (size_t)(bench_random() % 25);
+        bench_string(left, left_length, alphabet);
+        if (bench_random() % 4 == 0) {
+            right_length = bench_length();
+            bench_string(right, right_length, alphabet);
+        } else {
+            bench_mutate(right, &right_length, left, left_length, (size_t)(bench_random() % 12));
+        }
+
+        int expected = reference_distance(left, left_length, right, right_length);
+        int bounds[] = {-1, 0, expected - 1, expected, expected + 1, (int)(bench_random() % 40),
+                        (int)(left_length > right_length ? left_length : right_length)};
+        for (size_t b = 0; b < sizeof(bounds) / sizeof(bounds[0]); ++b) {
+            int bound = bounds[b];
+            int want = bound < 0 ? INT_MAX : (expected <= bound ? expected : bound + 1);
+            int got = edit_distance_bounded(left, left_length, right, right_length, bound);
+            if (got != want) {
+                fprintf(
+                    stderr,
+                    "Bounded distance mismatch: \"%s\" vs \"%s\" bound %d: got %d, want %d\n",
+                    left,
+                    right,
+                    bound,
+                    got,
+                    want);
+                ++failures;
+            }
+            if (bound < 0 || left_length == 0 || right_length == 0) {
+                continue;
+            }
+            got = banded_distance(left, left_length, right, right_length, bound);
+            if (got != want) {
+                fprintf(
+                    stderr,
+                    "Banded distance mismatch: \"%s\" vs \"%s\" bound %d: got %d, want %d\n",
+                    left,
+                    right,
+                    bound,
+                    got,
+                    want);
+                ++failures;
+            }
+            if (left_length <= AMS_EDIT_DISTANCE_WORD_BITS) {
+                got = myers_distance(left, left_length, right, right_length, bound);
+                if (got != want) {
+                    fprintf(
+                        stderr,
+                        "Myers distance mismatch: \"%s\" vs \"%s\" bound %d: got %d, want %d\n",
+                        left,
+                        right,
+                        bound,
+                        got,
+                        want);
+                    ++failures;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+static int check_batches(size_t rounds) {
+    char query[AMS_BENCH_MAX_LENGTH + 1];
+    char storage[AMS_BENCH_BATCH_SIZE][AMS_BENCH_MAX_LENGTH + 1];
+    const char *candidates[AMS_BENCH_BATCH_SIZE];
+    size_t candidate_lengths[AMS_BENCH_BATCH_SIZE];
+    int failures = 0;
+    for (size_t round = 0; round < rounds / AMS_BENCH_BATCH_SIZE + 1 && failures < 10; ++round) {
+        size_t query_length = 1 + (size_t)(bench_random() % AMS_EDIT_DISTANCE_LANE_BITS);
+        if (round % 4 == 0) {
+            query_length = AMS_EDIT_DISTANCE_LANE_BITS;
+        }
+        size_t alphabet = 2 + (size_t)(bench_random() % 25);
+        bench_string(query, query_length, alphabet);
+        size_t count = 1 + (size_t)(bench_random() % AMS_BENCH_BATCH_SIZE);
+        for (size_t i = 0; i < count; ++i) {
+            if (bench_random() % 3 == 0) {
+                candidate_lengths[i] = bench_length();
+                bench_string(storage[i], candidate_lengths[i], alphabet);
+            } else {
+                bench_mutate(storage[i], &candidate_lengths[i], query, query_length, (size_t)(bench_random() % 8));
+            }
+            candidates[i] = storage[i];
+        }
+
+        failures += check_batch("Scalar", batch_scalar, query, query_length, candidates, candidate_lengths, count);
+        failures += check_batch("Dispatched", edit_distance_batch, query, query_length, candidates, candidate_lengths, count);
+#ifdef AMS_EDIT_DISTANCE_X86
+        if (__builtin_cpu_supports("sse4.1")) {
+            failures += check_batch("SSE4.1", batch_sse41, query, query_length, candidates, candidate_lengths, count);
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            failures += check_batch("AVX2", batch_avx2, query, query_length, candidates, candidate_lengths, count);
+        }
+#endif
+    }
+    return failures;
+}
+
+static int check_batch(
+    const char *name,
+    BatchFunction batch,
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count) {
+    int distances[AMS_BENCH_BATCH_SIZE];
+    batch(query, query_length, candidates, candidate_lengths, count, distances);
+    int failures = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int want = reference_distance(query, query_length, candidates[i], candidate_lengths[i]);
+        if (distances[i] != want) {
+            fprintf(
+                stderr,
+                "%s batch mismatch: \"%s\" vs \"%s\": got %d, want %d\n",
+                name,
+                query,
+                candidates[i],
+                distances[i],
+                want);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+static double elapsed_ns(const struct timespec *start, const struct timespec *end) {
+    return (double)(end->tv_sec - start->tv_sec) * 1e9 + (double)(end->tv_nsec - start->tv_nsec);
+}
+
+static void time_bounded(size_t length, int max_distance) {
+    char left[AMS_BENCH_MAX_LENGTH + 1];
+    char right[AMS_BENCH_MAX_LENGTH + 1];
+    size_t right_length = 0;
+    bench_string(left, length, 26);
+    bench_mutate(right, &right_length, left, length, (size_t)max_distance / 2);
+
+    struct timespec start;
+    struct timespec end;
+    volatile int sink = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < AMS_BENCH_TIMING_CALLS; ++i) {
+        sink += edit_distance_bounded(left, length, right, right_length, max_distance);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double reference_calls = AMS_BENCH_TIMING_CALLS / 10;
+    struct timespec reference_start;
+    clock_gettime(CLOCK_MONOTONIC, &reference_start);
+    for (size_t i = 0; i < (size_t)reference_calls; ++i) {
+        sink += reference_distance(left, length, right, right_length);
+    }
+    struct timespec reference_end;
+    clock_gettime(CLOCK_MONOTONIC, &reference_end);
+    (void)sink;
+    printf(
+        "bounded length %3zu bound %2d: %8.1f ns/call (scalar DP %8.1f ns/call)\n",
+        length,
+        max_distance,
+        elapsed_ns(&start, &end) / AMS_BENCH_TIMING_CALLS,
+        elapsed_ns(&reference_start, &reference_end) / reference_calls);
+}
+
+static void time_batch(const char *name, BatchFunction batch, size_t query_length) {
+    char query[AMS_BENCH_MAX_LENGTH + 1];
+    char storage[AMS_BENCH_BATCH_SIZE][AMS_BENCH_MAX_LENGTH + 1];
+    const char *candidates[AMS_BENCH_BATCH_SIZE];
+    size_t candidate_lengths[AMS_BENCH_BATCH_SIZE];
+    int distances[AMS_BENCH_BATCH_SIZE];
+    bench_string(query, query_length, 26);
+    for (size_t i = 0; i < AMS_BENCH_BATCH_SIZE; ++i) {
+        bench_mutate(storage[i], &candidate_lengths[i], query, query_length, 1 + i % 4);
+        candidates[i] = storage[i];
+    }
+
+    size_t calls = AMS_BENCH_TIMING_CALLS / AMS_BENCH_BATCH_SIZE;
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < calls; ++i) {
+        batch(query, query_length, candidates, candidate_lengths, AMS_BENCH_BATCH_SIZE, distances);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf(
+        "batch %-6s query length %zu: %8.1f ns/candidate\n",
+        name,
+        query_length,
+        elapsed_ns(&start, &end) / (double)(calls * AMS_BENCH_BATCH_SIZE));
+}
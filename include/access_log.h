@@ -0,0 +1,53 @@
+#ifndef ACCESS_LOG_H
+#define ACCESS_LOG_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define AMS_ACCESS_LOG_CLIENT_LENGTH 48
+#define AMS_ACCESS_LOG_METHOD_LENGTH 8
+#define AMS_ACCESS_LOG_PATH_LENGTH 128
+#define AMS_ACCESS_LOG_STRATEGY_LENGTH 32
+
+typedef struct {
+    int64_t timestamp_ns;
+    uint64_t latency_ns;
+    int status;
+    double confidence;
+    uint32_t candidate_count;
+    char client[AMS_ACCESS_LOG_CLIENT_LENGTH];
+    char method[AMS_ACCESS_LOG_METHOD_LENGTH];
+    char path[AMS_ACCESS_LOG_PATH_LENGTH];
+    char strategy[AMS_ACCESS_LOG_STRATEGY_LENGTH];
+} AccessLogEntry;
+
+typedef struct {
+    AccessLogEntry *entries;
+    size_t mask;
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+    atomic_ullong dropped;
+} AccessLogRing;
+
+typedef struct {
+    char *path;
+    FILE *file;
+    AccessLogRing *rings;
+    size_t ring_count;
+    atomic_size_t attached;
+    atomic_int running;
+    atomic_int reopen;
+    pthread_t drain_thread;
+} AccessLog;
+
+int access_log_open(AccessLog *log, const char *path, size_t ring_count, size_t ring_size);
+void access_log_close(AccessLog *log);
+AccessLogRing *access_log_attach(AccessLog *log);
+void access_log_record(AccessLogRing *ring, const AccessLogEntry *entry);
+void access_log_reopen(AccessLog *log);
+unsigned long long access_log_dropped(AccessLog *log);
+
+#endif /* ACCESS_LOG_H */
@@ -2,6 +2,10 @@
 #define ADDRESS_MATCHER_H
 
 #include <stddef.h>
+#include <stdint.h>
+
+#include "location_index.h"
+#include "numa_placement.h"
 
 #define AMS_MAX_ID_LENGTH 64
 #define AMS_MAX_FIELD_LENGTH 128
@@ -11,11 +15,11 @@
 #define AMS_MAX_SUFFIX_LENGTH 32
 #define AMS_MAX_CANONICAL_LENGTH 256
 #define AMS_MAX_LINE_LENGTH 512
-#define AMS_MAX_REASON_LENGTH 128
 #define AMS_MAX_STRATEGY_LENGTH 32
 #define AMS_MAX_DIAGNOSTIC_LENGTH 64
 #define MATCHER_MAX_CANDIDATES 16
 #define MATCHER_MAX_BREAKDOWN_ENTRIES 8
+#define MATCHER_SCORE_COMPONENTS 7
 
 typedef struct {
     char street_number[AMS_MAX_FIELD_LENGTH];
@@ -41,6 +45,11 @@ typedef struct {
     ScoreComparison comparisons[MATCHER_MAX_BREAKDOWN_ENTRIES];
 } ScoreBreakdown;
 
+typedef struct {
+    double score;
+    double components[MATCHER_SCORE_COMPONENTS];
+} ComponentScores;
+
 typedef struct {
     char location_id[AMS_MAX_ID_LENGTH];
     char street[AMS_MAX_FIELD_LENGTH];
@@ -48,24 +57,48 @@ typedef struct {
     char state[AMS_MAX_STATE_LENGTH];
     char postal_code[AMS_MAX_POSTAL_LENGTH];
     AddressComponents components;
+    uint64_t id_fingerprint;
+    uint32_t street_name_id;
+    uint32_t city_id;
 } LocationRecord;
 
 typedef struct {
     LocationRecord *items;
     size_t count;
     size_t capacity;
+    StringDictionary street_names;
+    StringDictionary cities;
+    KeyIndex canonical_index;
+    KeyIndex id_index;
+    KeyIndex postal_number_index;
+    KeyIndex city_number_index;
+    KeyIndex postal_index;
+    KeyIndex city_index;
+    KeyIndex street_index;
+    KeyIndex state_street_index;
+    TrigramIndex street_trigrams;
+    BkTree street_name_tree;
+    BkTree city_tree;
+    KeyIndex street_phonetic_index;
+    KeyIndex city_phonetic_index;
+    char *json_fragments;
+    uint32_t *json_offsets;
+    PlacementArena placement;
 } LocationStore;
 
 typedef struct {
     const LocationRecord *location;
     double confidence;
-    char strategy[AMS_MAX_STRATEGY_LENGTH];
-    char reason[AMS_MAX_REASON_LENGTH];
-    ScoreBreakdown breakdown;
+    const char *strategy;
+    const char *reason;
+    ComponentScores scores;
 } MatchCandidate;
 
 typedef struct {
     MatchCandidate items[MATCHER_MAX_CANDIDATES];
+    uint64_t candidate_keys[MATCHER_MAX_CANDIDATES];
+    uint8_t heap[MATCHER_MAX_CANDIDATES];
+    uint8_t heap_positions[MATCHER_MAX_CANDIDATES];
     size_t count;
     int has_best_candidate;
     size_t best_index;
@@ -73,21 +106,49 @@ typedef struct {
     char selected_confidence[AMS_MAX_DIAGNOSTIC_LENGTH];
     AddressComponents record_components;
     char raw_address[AMS_MAX_LINE_LENGTH];
+    int degraded;
 } MatchResult;
 
 typedef struct {
     double structured_min_confidence;
     double fuzzy_min_confidence;
     double llm_min_confidence;
+    double llm_margin_delta;
+    double llm_uncertain_min;
+    double llm_uncertain_max;
     size_t max_candidates;
+    size_t scan_threads;
+    size_t parallel_scan_min_block;
     int llm_enabled;
     char llm_command[AMS_MAX_FIELD_LENGTH];
+    size_t llm_workers;
+    int llm_timeout_ms;
+    size_t llm_batch_size;
+    int llm_batch_linger_ms;
+    int request_budget_ms;
+    size_t llm_cache_size;
+    char llm_cache_path[AMS_MAX_FIELD_LENGTH];
 } MatcherConfig;
 
+typedef struct {
+    unsigned long long llm_invoked;
+    unsigned long long llm_skipped;
+    unsigned long long llm_cache_hits;
+} MatcherStats;
+
 int location_store_init(LocationStore *store);
 void location_store_free(LocationStore *store);
 int location_store_load(LocationStore *store, const char *connection_uri);
+int location_store_replicate(const LocationStore *source, LocationStore *replica, int huge_pages);
+const LocationRecord *location_store_find(const LocationStore *store, const char *location_id);
+const char *location_store_json_id(const LocationStore *store, const LocationRecord *location, size_t *length);
+const char *location_store_json_address(const LocationStore *store, const LocationRecord *location, size_t *length);
 
+int matcher_load_rules(const char *path, char *error, size_t error_size);
+const char *matcher_rules_version(void);
+int matcher_start_llm(const MatcherConfig *config, const LocationStore *store);
+void matcher_stop_llm(void);
+void matcher_stats_snapshot(MatcherStats *stats);
 int parse_address(const char *input, AddressComponents *out);
 void matcher_config_init(MatcherConfig *config);
 void match_record(
@@ -95,5 +156,6 @@ void match_record(
     const LocationStore *store,
     const MatcherConfig *config,
     MatchResult *result);
+int match_result_explain(const MatchResult *result, size_t index, ScoreBreakdown *breakdown);
 
 #endif /* ADDRESS_MATCHER_H */
@@ -0,0 +1,21 @@
+#ifndef EDIT_DISTANCE_H
+#define EDIT_DISTANCE_H
+
+#include <stddef.h>
+
+int edit_distance(const char *left, size_t left_length, const char *right, size_t right_length);
+int edit_distance_bounded(
+    const char *left,
+    size_t left_length,
+    const char *right,
+    size_t right_length,
+    int max_distance);
+void edit_distance_batch(
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count,
+    int *distances);
+
+#endif /* EDIT_DISTANCE_H */
@@ -0,0 +1,21 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stddef.h>
+
+#define AMS_JSON_MAX_DECIMALS 3
+
+typedef struct {
+    char *buffer;
+    size_t size;
+    size_t length;
+    int truncated;
+} JsonWriter;
+
+void json_writer_init(JsonWriter *writer, char *buffer, size_t size);
+void json_writer_append(JsonWriter *writer, const char *data, size_t length);
+void json_writer_append_raw(JsonWriter *writer, const char *text);
+void json_writer_append_escaped(JsonWriter *writer, const char *value, size_t limit);
+void json_writer_append_fixed(JsonWriter *writer, double value, int decimals);
+
+#endif /* JSON_WRITER_H */
@@ -0,0 +1,37 @@
+#ifndef LLM_CACHE_H
+#define LLM_CACHE_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define AMS_LLM_CACHE_ID_LENGTH 64
+
+typedef struct {
+    uint64_t key;
+    double confidence;
+    int referenced;
+    char location_id[AMS_LLM_CACHE_ID_LENGTH];
+} LlmCacheEntry;
+
+typedef struct {
+    LlmCacheEntry *entries;
+    uint32_t *slots;
+    size_t slot_mask;
+    size_t capacity;
+    size_t count;
+    size_t hand;
+    uint64_t fingerprint;
+    char *path;
+    FILE *journal;
+    size_t journal_records;
+    pthread_mutex_t lock;
+} LlmCache;
+
+int llm_cache_open(LlmCache *cache, const char *path, size_t capacity, uint64_t fingerprint);
+void llm_cache_close(LlmCache *cache);
+int llm_cache_lookup(LlmCache *cache, uint64_t key, char *location_id, size_t location_id_size, double *confidence);
+void llm_cache_store(LlmCache *cache, uint64_t key, const char *location_id, double confidence);
+
+#endif /* LLM_CACHE_H */
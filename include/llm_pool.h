@@ -0,0 +1,58 @@
+#ifndef LLM_POOL_H
+#define LLM_POOL_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <time.h>
+
+#define AMS_LLM_POOL_MAX_WORKERS 32
+#define AMS_LLM_POOL_MAX_BATCH 64
+
+typedef struct {
+    pid_t pid;
+    int request_fd;
+    int response_fd;
+    int busy;
+} LlmWorker;
+
+typedef struct LlmPending {
+    const char *request;
+    char *response;
+    size_t response_size;
+    struct timespec deadline;
+    int status;
+    int done;
+    struct LlmPending **claim;
+    struct LlmPending *next;
+} LlmPending;
+
+typedef struct {
+    char *command;
+    LlmWorker *workers;
+    size_t worker_count;
+    int timeout_ms;
+    size_t batch_size;
+    int linger_ms;
+    int running;
+    LlmPending *pending_head;
+    LlmPending *pending_tail;
+    size_t pending_count;
+    int batch_leader;
+    pthread_mutex_t lock;
+    pthread_cond_t available;
+    pthread_cond_t batch_ready;
+    pthread_cond_t batch_done;
+} LlmPool;
+
+int llm_pool_start(
+    LlmPool *pool,
+    const char *command,
+    size_t worker_count,
+    int timeout_ms,
+    size_t batch_size,
+    int linger_ms);
+void llm_pool_stop(LlmPool *pool);
+int llm_pool_call(LlmPool *pool, const char *request, char *response, size_t response_size, int timeout_ms);
+
+#endif /* LLM_POOL_H */
@@ -0,0 +1,91 @@
+#ifndef LOCATION_INDEX_H
+#define LOCATION_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define AMS_DICTIONARY_NONE UINT32_MAX
+
+typedef struct {
+    char *arena;
+    size_t arena_length;
+    size_t arena_capacity;
+    uint32_t *offsets;
+    uint64_t *hashes;
+    size_t count;
+    size_t capacity;
+    uint32_t *slots;
+    size_t slot_count;
+} StringDictionary;
+
+typedef struct {
+    uint64_t fingerprint;
+    uint32_t start;
+    uint32_t length;
+} KeyIndexSlot;
+
+typedef struct {
+    KeyIndexSlot *slots;
+    size_t slot_count;
+    uint32_t *postings;
+    size_t posting_count;
+} KeyIndex;
+
+typedef struct {
+    KeyIndex grams;
+    uint16_t *gram_counts;
+    size_t name_count;
+} TrigramIndex;
+
+typedef struct {
+    uint32_t name_id;
+    uint32_t distance;
+    uint32_t first_child;
+    uint32_t next_sibling;
+} BkTreeNode;
+
+typedef struct {
+    BkTreeNode *nodes;
+    size_t node_count;
+} BkTree;
+
+uint64_t ams_hash_bytes(uint64_t seed, const void *data, size_t length);
+uint64_t ams_hash_string(const char *value);
+uint64_t ams_fingerprint(const char *value);
+
+void string_dictionary_init(StringDictionary *dictionary);
+void string_dictionary_free(StringDictionary *dictionary);
+int string_dictionary_intern(StringDictionary *dictionary, const char *value, uint32_t *id_out);
+uint32_t string_dictionary_find(const StringDictionary *dictionary, const char *value);
+uint32_t string_dictionary_find_length(const StringDictionary *dictionary, const char *value, size_t length);
+const char *string_dictionary_get(const StringDictionary *dictionary, uint32_t id);
+
+void key_index_init(KeyIndex *index);
+void key_index_free(KeyIndex *index);
+int key_index_build(KeyIndex *index, const uint64_t *fingerprints, size_t count);
+int key_index_build_pairs(KeyIndex *index, const uint64_t *fingerprints, const uint32_t *values, size_t count);
+const uint32_t *key_index_lookup(const KeyIndex *index, uint64_t fingerprint, size_t *count);
+
+void trigram_index_init(TrigramIndex *index);
+void trigram_index_free(TrigramIndex *index);
+int trigram_index_build(TrigramIndex *index, const StringDictionary *names);
+int trigram_index_search(
+    const TrigramIndex *index,
+    const StringDictionary *names,
+    const char *query,
+    double min_similarity,
+    uint32_t **ids_out,
+    size_t *count_out);
+
+void bk_tree_init(BkTree *tree);
+void bk_tree_free(BkTree *tree);
+int bk_tree_build(BkTree *tree, const StringDictionary *names);
+int bk_tree_search(
+    const BkTree *tree,
+    const StringDictionary *names,
+    const char *query,
+    int max_distance,
+    uint32_t **ids_out,
+    size_t *count_out);
+
+#endif /* LOCATION_INDEX_H */
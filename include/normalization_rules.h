@@ -0,0 +1,43 @@
+#ifndef NORMALIZATION_RULES_H
+#define NORMALIZATION_RULES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "location_index.h"
+#include "text_rewriter.h"
+
+#define AMS_KEYWORD_STATE 0x01u
+#define AMS_KEYWORD_DIRECTION 0x02u
+#define AMS_KEYWORD_SUFFIX 0x04u
+#define AMS_KEYWORD_UNIT 0x08u
+#define AMS_RULES_VERSION_LENGTH 64
+
+typedef struct {
+    const char *text;
+    unsigned char length;
+    unsigned char kinds;
+    const char *canonical;
+} ParserKeyword;
+
+typedef struct {
+    char version[AMS_RULES_VERSION_LENGTH];
+    StringDictionary keyword_texts;
+    StringDictionary rewrite_needles;
+    StringDictionary values;
+    ParserKeyword *keywords;
+    uint32_t *canonical_ids;
+    size_t keyword_count;
+    size_t keyword_capacity;
+    RewriteRule *rewrites;
+    uint32_t *replacement_ids;
+    size_t rewrite_count;
+    size_t rewrite_capacity;
+} NormalizationRules;
+
+void normalization_rules_init(NormalizationRules *rules);
+void normalization_rules_free(NormalizationRules *rules);
+int normalization_rules_load(NormalizationRules *rules, const char *path, char *error, size_t error_size);
+const ParserKeyword *normalization_rules_lookup(const NormalizationRules *rules, const char *text, size_t length);
+
+#endif /* NORMALIZATION_RULES_H */
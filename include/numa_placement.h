@@ -0,0 +1,37 @@
+#ifndef NUMA_PLACEMENT_H
+#define NUMA_PLACEMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define AMS_NUMA_MAX_NODES 16
+#define AMS_NUMA_MAX_CPUS 1024
+
+typedef enum {
+    PLACEMENT_PAGES_DEFAULT,
+    PLACEMENT_PAGES_TRANSPARENT,
+    PLACEMENT_PAGES_HUGETLB
+} PlacementPages;
+
+typedef struct {
+    size_t node_count;
+    int node_ids[AMS_NUMA_MAX_NODES];
+    uint64_t cpus[AMS_NUMA_MAX_NODES][AMS_NUMA_MAX_CPUS / 64];
+} NumaTopology;
+
+typedef struct {
+    unsigned char *base;
+    size_t size;
+    size_t used;
+    PlacementPages pages;
+} PlacementArena;
+
+void numa_topology_load(NumaTopology *topology);
+int numa_topology_bind(const NumaTopology *topology, size_t node);
+
+void placement_arena_init(PlacementArena *arena);
+int placement_arena_map(PlacementArena *arena, size_t size, int huge_pages);
+void *placement_arena_copy(PlacementArena *arena, const void *data, size_t size);
+void placement_arena_release(PlacementArena *arena);
+
+#endif /* NUMA_PLACEMENT_H */
@@ -0,0 +1,22 @@
+#ifndef PARSER_KEYWORDS_H
+#define PARSER_KEYWORDS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "normalization_rules.h"
+
+#define AMS_KEYWORD_SLOTS 128
+#define AMS_KEYWORD_SLOT_SHIFT 25
+#define AMS_KEYWORD_BUCKETS 32
+#define AMS_KEYWORD_MAX_LENGTH 9
+#define AMS_KEYWORD_MULTIPLIER 0x9E3779B1u
+
+extern const unsigned char PARSER_KEYWORD_DISPLACEMENTS[AMS_KEYWORD_BUCKETS];
+extern const ParserKeyword PARSER_KEYWORDS[AMS_KEYWORD_SLOTS];
+
+uint32_t parser_keyword_slot(uint64_t hash, unsigned displacement);
+const ParserKeyword *parser_keyword_find(const char *text, size_t length);
+int parser_keywords_verify(void);
+
+#endif /* PARSER_KEYWORDS_H */
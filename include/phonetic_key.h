@@ -0,0 +1,10 @@
+#ifndef PHONETIC_KEY_H
+#define PHONETIC_KEY_H
+
+#include <stddef.h>
+
+#define AMS_PHONETIC_KEY_LENGTH 16
+
+size_t phonetic_key(const char *value, char *key, size_t key_size);
+
+#endif /* PHONETIC_KEY_H */
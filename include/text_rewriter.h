@@ -0,0 +1,41 @@
+#ifndef TEXT_REWRITER_H
+#define TEXT_REWRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define AMS_REWRITE_MAX_NEEDLE 64
+
+typedef struct {
+    const char *needle;
+    const char *replacement;
+} RewriteRule;
+
+typedef struct {
+    char *arena;
+    uint32_t *needle_offsets;
+    uint32_t *needle_lengths;
+    uint32_t *consumed_lengths;
+    uint32_t *replacement_offsets;
+    uint32_t *replacement_lengths;
+    size_t rule_count;
+    size_t max_needle_length;
+    uint8_t byte_classes[256];
+    size_t class_count;
+    uint32_t *transitions;
+    int32_t *outputs;
+    uint32_t *output_links;
+    size_t state_count;
+} TextRewriter;
+
+void text_rewriter_init(TextRewriter *rewriter);
+void text_rewriter_free(TextRewriter *rewriter);
+int text_rewriter_build(TextRewriter *rewriter, const RewriteRule *rules, size_t count);
+size_t text_rewriter_apply(
+    const TextRewriter *rewriter,
+    const char *text,
+    size_t length,
+    char *out,
+    size_t out_size);
+
+#endif /* TEXT_REWRITER_H */
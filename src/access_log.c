@@ -0,0 +1,259 @@
+#define _POSIX_C_SOURCE 200809L
+#include "access_log.h"
+
+#include "json_writer.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define AMS_ACCESS_LOG_BATCH_SIZE 65536
+#define AMS_ACCESS_LOG_LINE_LENGTH 512
+#define AMS_ACCESS_LOG_FLUSH_MS 100
+#define AMS_ACCESS_LOG_ALIGNMENT 64
+
+static void *access_log_drain(void *arg);
+static size_t access_log_drain_rings(AccessLog *log, char *batch, size_t batch_size);
+static void access_log_write(AccessLog *log, const char *batch, size_t length);
+static void access_log_rotate(AccessLog *log);
+static void access_log_format(JsonWriter *writer, const AccessLogEntry *entry);
+
+int access_log_open(AccessLog *log, const char *path, size_t ring_count, size_t ring_size) {
+    if (log == NULL) {
+        return -1;
+    }
+    memset(log, 0, sizeof(*log));
+    if (path == NULL || path[0] == '\0') {
+        return 0;
+    }
+    if (ring_count == 0 || ring_size == 0) {
+        return -1;
+    }
+
+    size_t slot_count = 1;
+    while (slot_count < ring_size) {
+        slot_count <<= 1;
+    }
+    size_t path_length = strlen(path);
+    log->path = malloc(path_length + 1);
+    log->rings = aligned_alloc(AMS_ACCESS_LOG_ALIGNMENT, ring_count * sizeof(AccessLogRing));
+    if (log->path == NULL || log->rings == NULL) {
+        free(log->path);
+        free(log->rings);
+        memset(log, 0, sizeof(*log));
+        return -1;
+    }
+    memcpy(log->path, path, path_length + 1);
+    memset(log->rings, 0, ring_count * sizeof(AccessLogRing));
+    log->ring_count = ring_count;
+
+    int failed = 0;
+    for (size_t i = 0; i < ring_count; ++i) {
+        AccessLogRing *ring = &log->rings[i];
+        atomic_init(&ring->head, 0);
+        atomic_init(&ring->tail, 0);
+        atomic_init(&ring->dropped, 0);
+        ring->mask = slot_count - 1;
+        ring->entries = malloc(slot_count * sizeof(AccessLogEntry));
+        failed |= ring->entries == NULL;
+    }
+    atomic_init(&log->attached, 0);
+    atomic_init(&log->running, 1);
+    atomic_init(&log->reopen, 0);
+
+    if (!failed) {
+        log->file = fopen(path, "a");
+        failed = log->file == NULL;
+    }
+    if (!failed && pthread_create(&log->drain_thread, NULL, access_log_drain, log) != 0) {
+        fclose(log->file);
+        log->file = NULL;
+        failed = 1;
+    }
+    if (failed) {
+        for (size_t i = 0; i < ring_count; ++i) {
+            free(log->rings[i].entries);
+        }
+        free(log->rings);
+        free(log->path);
+        memset(log, 0, sizeof(*log));
+        return -1;
+    }
+    return 0;
+}
+
+void access_log_close(AccessLog *log) {
+    if (log == NULL || log->rings == NULL) {
+        return;
+    }
+    atomic_store(&log->running, 0);
+    pthread_join(log->drain_thread, NULL);
+    if (log->file != NULL) {
+        fclose(log->file);
+    }
+    for (size_t i = 0; i < log->ring_count; ++i) {
+        free(log->rings[i].entries);
+    }
+    free(log->rings);
+    free(log->path);
+    memset(log, 0, sizeof(*log));
+}
+
+AccessLogRing *access_log_attach(AccessLog *log) {
+    if (log == NULL || log->rings == NULL) {
+        return NULL;
+    }
+    size_t index = atomic_fetch_add(&log->attached, 1);
+    return index < log->ring_count ? &log->rings[index] : NULL;
+}
+
+void access_log_record(AccessLogRing *ring, const AccessLogEntry *entry) {
+    if (ring == NULL || entry == NULL) {
+        return;
+    }
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - head > ring->mask) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    ring->entries[tail & ring->mask] = *entry;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+void access_log_reopen(AccessLog *log) {
+    if (log != NULL) {
+        atomic_store(&log->reopen, 1);
+    }
+}
+
+unsigned long long access_log_dropped(AccessLog *log) {
+    if (log == NULL || log->rings == NULL) {
+        return 0;
+    }
+    unsigned long long dropped = 0;
+    for (size_t i = 0; i < log->ring_count; ++i) {
+        dropped += atomic_load_explicit(&log->rings[i].dropped, memory_order_relaxed);
+    }
+    return dropped;
+}
+
+static void *access_log_drain(void *arg) {
+    AccessLog *log = (AccessLog *)arg;
+    char *batch = malloc(AMS_ACCESS_LOG_BATCH_SIZE);
+    if (batch == NULL) {
+        return NULL;
+    }
+
+    struct timespec pause = {0, AMS_ACCESS_LOG_FLUSH_MS * 1000000L};
+    for (;;) {
+        int running = atomic_load(&log->running);
+        if (atomic_exchange(&log->reopen, 0)) {
+            access_log_rotate(log);
+        }
+        size_t drained = access_log_drain_rings(log, batch, AMS_ACCESS_LOG_BATCH_SIZE);
+        if (!running) {
+            break;
+        }
+        if (drained == 0) {
+            nanosleep(&pause, NULL);
+        }
+    }
+    free(batch);
+    return NULL;
+}
+
+static size_t access_log_drain_rings(AccessLog *log, char *batch, size_t batch_size) {
+    size_t drained = 0;
+    size_t length = 0;
+    for (size_t i = 0; i < log->ring_count; ++i) {
+        AccessLogRing *ring = &log->rings[i];
+        size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        for (; head != tail; ++head) {
+            if (batch_size - length < AMS_ACCESS_LOG_LINE_LENGTH) {
+                access_log_write(log, batch, length);
+                length = 0;
+            }
+            JsonWriter writer;
+            json_writer_init(&writer, batch + length, AMS_ACCESS_LOG_LINE_LENGTH);
+            access_log_format(&writer, &ring->entries[head & ring->mask]);
+            length += writer.length;
+            ++drained;
+        }
+        atomic_store_explicit(&ring->head, head, memory_order_release);
+    }
+    if (length > 0) {
+        access_log_write(log, batch, length);
+    }
+    if (drained > 0 && log->file != NULL) {
+        fflush(log->file);
+    }
+    return drained;
+}
+
+static void access_log_write(AccessLog *log, const char *batch, size_t length) {
+    if (log->file != NULL) {
+        fwrite(batch, 1, length, log->file);
+    }
+}
+
+static void access_log_rotate(AccessLog *log) {
+    FILE *file = fopen(log->path, "a");
+    if (file == NULL) {
+        fprintf(
+            stderr,
+            "Unable to reopen access log %s, still writing to the previous file: %s\n",
+            log->path,
+            strerror(errno));
+        return;
+    }
+    if (log->file != NULL) {
+        fclose(log->file);
+    }
+    log->file = file;
+}
+
+static void access_log_format(JsonWriter *writer, const AccessLogEntry *entry) {
+    time_t seconds = (time_t)(entry->timestamp_ns / 1000000000LL);
+    struct tm utc;
+    char timestamp[40] = "";
+    if (gmtime_r(&seconds, &utc) != NULL) {
+        size_t written = strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", &utc);
+        snprintf(
+            timestamp + written,
+            sizeof(timestamp) - written,
+            ".%03dZ",
+            (int)(entry->timestamp_ns % 1000000000LL / 1000000LL));
+    }
+
+    json_writer_append_raw(writer, "{ \"timestamp\": \"");
+    json_writer_append_raw(writer, timestamp);
+    json_writer_append_raw(writer, "\", \"client\": \"");
+    json_writer_append_escaped(writer, entry->client, AMS_ACCESS_LOG_CLIENT_LENGTH - 1);
+    json_writer_append_raw(writer, "\", \"method\": \"");
+    json_writer_append_escaped(writer, entry->method, AMS_ACCESS_LOG_METHOD_LENGTH - 1);
+    json_writer_append_raw(writer, "\", \"path\": \"");
+    json_writer_append_escaped(writer, entry->path, AMS_ACCESS_LOG_PATH_LENGTH - 1);
+    json_writer_append_raw(writer, "\", \"status\": ");
+    char status[16];
+    snprintf(status, sizeof(status), "%d", entry->status);
+    json_writer_append_raw(writer, status);
+    json_writer_append_raw(writer, ", \"latency_ms\": ");
+    json_writer_append_fixed(writer, (double)entry->latency_ns / 1e6, 3);
+    if (entry->strategy[0] != '\0') {
+        json_writer_append_raw(writer, ", \"strategy\": \"");
+        json_writer_append_escaped(writer, entry->strategy, AMS_ACCESS_LOG_STRATEGY_LENGTH - 1);
+        json_writer_append_raw(writer, "\", \"confidence\": ");
+        if (entry->confidence >= 0.0) {
+            json_writer_append_fixed(writer, entry->confidence, 3);
+        } else {
+            json_writer_append_raw(writer, "null");
+        }
+        char candidates[32];
+        snprintf(candidates, sizeof(candidates), ", \"candidates\": %u", (unsigned)entry->candidate_count);
+        json_writer_append_raw(writer, candidates);
+    }
+    json_writer_append_raw(writer, " }\n");
+}
@@ -1,36 +1,159 @@
 #define _POSIX_C_SOURCE 200809L
 #include "address_matcher.h"
+#include "edit_distance.h"
+#include "json_writer.h"
+#include "llm_cache.h"
+#include "llm_pool.h"
+#include "normalization_rules.h"
+#include "parser_keywords.h"
+#include "phonetic_key.h"
+#include "text_rewriter.h"
 
 #include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <libpq-fe.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #define AMS_MAX_TOKENS 64
+#define AMS_JSON_FRAGMENT_LENGTH 1024
 #define AMS_DEFAULT_STRUCTURED_THRESHOLD 0.65
 #define AMS_DEFAULT_FUZZY_THRESHOLD 0.55
 #define AMS_DEFAULT_LLM_THRESHOLD 0.70
+#define AMS_DEFAULT_LLM_MARGIN 0.05
+#define AMS_DEFAULT_LLM_UNCERTAIN_MIN 0.55
+#define AMS_DEFAULT_LLM_UNCERTAIN_MAX 0.85
 #define AMS_DEFAULT_MAX_CANDIDATES 5
+#define AMS_DEFAULT_SCAN_THREADS 1
+#define AMS_DEFAULT_PARALLEL_SCAN_MIN_BLOCK 50000
+#define AMS_MAX_SCAN_THREADS 64
 #define AMS_LLM_PAYLOAD_LIMIT 4096
 #define AMS_LLM_MAX_INPUT_CANDIDATES 5
+#define AMS_LLM_RESPONSE_LIMIT 512
+#define AMS_DEFAULT_LLM_WORKERS 2
+#define AMS_DEFAULT_LLM_TIMEOUT_MS 2000
+#define AMS_DEFAULT_LLM_CACHE_SIZE 4096
+#define AMS_DEFAULT_LLM_BATCH_SIZE 1
+#define AMS_DEFAULT_LLM_BATCH_LINGER_MS 2
+#define AMS_DEFAULT_REQUEST_BUDGET_MS 0
+#define AMS_LLM_MIN_BUDGET_MS 5
+#define AMS_BLOCK_POSTAL_LENGTH 5
+#define AMS_SCORE_BOUND_SLACK 1e-9
+#define AMS_SIMILARITY_REQUIRED_MARGIN 1e-6
+#define AMS_SIMILARITY_UNKNOWN 0
+#define AMS_SIMILARITY_EXACT 1
+#define AMS_SIMILARITY_BOUNDED 2
+#define AMS_SIMILARITY_PENDING 3
+#define AMS_BLOCK_CHUNK 64
+#define AMS_SIMILARITY_BATCH_MIN 8
 
 typedef struct {
-    const char *needle;
-    const char *replacement;
-} Replacement;
+    const char *start;
+    size_t length;
+    unsigned kinds;
+} TokenSpan;
 
 typedef struct {
-    const char *token;
-    const char *canonical;
-} TokenMapping;
+    const StringDictionary *dictionary;
+    const char *query_value;
+    double *values;
+    unsigned char *known;
+} SimilarityMemo;
+
+typedef struct {
+    const AddressComponents *query;
+    SimilarityMemo street_names;
+    SimilarityMemo cities;
+    uint64_t deadline_ns;
+} ScoringContext;
+
+typedef struct {
+    const uint32_t *indices;
+    size_t base;
+    size_t count;
+    uint32_t *owned;
+    size_t capacity;
+} CandidateBlock;
+
+typedef struct {
+    const LocationStore *store;
+    const MatcherConfig *config;
+    ScoringContext *context;
+    CandidateBlock block;
+    MatchResult *result;
+} ScanPartition;
+
+typedef enum {
+    BLOCK_TIER_PRIMARY,
+    BLOCK_TIER_POSTAL,
+    BLOCK_TIER_CITY,
+    BLOCK_TIER_FULL_STORE,
+    BLOCK_TIER_COUNT
+} BlockTier;
 
 static int ensure_capacity(LocationStore *store, size_t required);
+static int location_store_build_indexes(LocationStore *store);
+static int location_store_build_json(LocationStore *store);
+static void location_store_copy(const LocationStore *source, LocationStore *replica, PlacementArena *arena, int *failed);
+static void string_dictionary_copy(
+    const StringDictionary *source,
+    StringDictionary *replica,
+    PlacementArena *arena,
+    int *failed);
+static void key_index_copy(const KeyIndex *source, KeyIndex *replica, PlacementArena *arena, int *failed);
+static void *placement_copy(PlacementArena *arena, const void *data, size_t size, int *failed);
+static void append_json_field(JsonWriter *writer, const char *prefix, const char *value);
+static int build_blocking_index(
+    KeyIndex *index,
+    const LocationStore *store,
+    uint64_t *fingerprints,
+    uint64_t (*key)(const AddressComponents *components));
+static int build_phonetic_index(KeyIndex *index, const StringDictionary *names);
+static uint64_t phonetic_fingerprint(const char *value);
+static int append_phonetic_matches(
+    const KeyIndex *index,
+    const char *value,
+    uint32_t **ids,
+    size_t *count);
+static uint64_t blocking_fingerprint(const char *first, const char *second, const char *third);
+static const char *blocking_postal(const AddressComponents *components, char *buffer, size_t buffer_size);
+static uint64_t postal_number_key(const AddressComponents *components);
+static uint64_t city_number_key(const AddressComponents *components);
+static uint64_t postal_key(const AddressComponents *components);
+static uint64_t city_key(const AddressComponents *components);
+static uint64_t street_key(const AddressComponents *components);
+static uint64_t state_street_key(const AddressComponents *components);
+static int collect_block(
+    const AddressComponents *query,
+    const LocationStore *store,
+    const MatcherConfig *config,
+    BlockTier tier,
+    CandidateBlock *block);
+static int collect_similar_streets(
+    const AddressComponents *query,
+    const LocationStore *store,
+    const MatcherConfig *config,
+    CandidateBlock *block);
+static int collect_similar_cities(
+    const AddressComponents *query,
+    const LocationStore *store,
+    const MatcherConfig *config,
+    int with_number,
+    CandidateBlock *block);
+static int fuzzy_edit_radius(const MatcherConfig *config, const char *value);
+static int merge_name_ids(uint32_t **ids, size_t *count, uint32_t *extra, size_t extra_count);
+static int candidate_block_append(CandidateBlock *block, const uint32_t *indices, size_t count);
+static void candidate_block_finalize(CandidateBlock *block);
+static void candidate_block_free(CandidateBlock *block);
+static int compare_record_indices(const void *lhs, const void *rhs);
 static void copy_field(char *dest, size_t dest_size, const char *src);
 static void uppercase_inplace(char *value);
 static void trim_whitespace(char *value);
@@ -42,22 +165,52 @@ static void add_breakdown_entry(
     const char *left,
     const char *right,
     double weight);
-static ScoreBreakdown score_components(
+static ComponentScores score_components(
     const AddressComponents *left,
     const AddressComponents *right,
+    double name_similarity,
+    double city_similarity,
+    int require_zip);
+static void similarity_memo_init(
+    SimilarityMemo *memo,
+    const StringDictionary *dictionary,
+    const char *query_value);
+static void similarity_memo_free(SimilarityMemo *memo);
+static double similarity_memo_lookup(SimilarityMemo *memo, uint32_t id, const char *value, double min_similarity);
+static void similarity_memo_prefetch(SimilarityMemo *memo, const uint32_t *ids, size_t count);
+static void scoring_context_init(
+    ScoringContext *context,
+    const AddressComponents *query,
+    const LocationStore *store);
+static void scoring_context_free(ScoringContext *context);
+static double location_name_similarity(
+    ScoringContext *context,
+    const LocationRecord *location,
+    double min_similarity);
+static double location_city_similarity(
+    ScoringContext *context,
+    const LocationRecord *location,
+    double min_similarity);
+static ComponentScores score_location(
+    ScoringContext *context,
+    const LocationRecord *location,
     int require_zip);
 static double similarity_ratio(const char *left, const char *right);
-static int levenshtein_distance(const char *left, const char *right);
-static int is_zip_code(const char *token);
+static double similarity_ratio_bounded(const char *left, const char *right, double min_similarity);
+static double similarity_from_distance(int distance, size_t max_len);
+static const ParserKeyword *lookup_keyword(const char *text, size_t length);
+static size_t tokenize_address(const char *text, TokenSpan *tokens, size_t max_tokens);
+static void copy_span(char *dest, size_t dest_size, const TokenSpan *token);
+static void append_span(char *dest, size_t dest_size, const char *text, size_t length);
+static int is_zip_code(const TokenSpan *token);
 static void canonicalize_zip(char *postal);
 static const char *normalize_direction(const char *token);
-static const char *normalize_state(const char *token);
-static int is_primary_suffix(const char *token);
-static int is_unit_token(const char *token);
-static int is_unit_followup(const char *token);
+static int normalize_state(const TokenSpan *token, char *state, size_t state_size);
+static int is_unit_followup(const TokenSpan *token);
+static void build_address_rewriter(void);
 static void expand_address_text(const char *source, char *dest, size_t dest_size);
-static void normalize_ordinal_token(char *token);
-static int extract_house_number(char *token, char *number_out, size_t number_size);
+static size_t ordinal_token_length(const TokenSpan *token);
+static int extract_house_number(TokenSpan *token, char *number_out, size_t number_size);
 static void match_result_init(MatchResult *result);
 static void add_candidate(
     MatchResult *result,
@@ -65,40 +218,76 @@ static void add_candidate(
     double confidence,
     const char *strategy,
     const char *reason,
-    const ScoreBreakdown *breakdown,
+    const ComponentScores *scores,
     size_t max_candidates);
+static void fill_candidate(
+    MatchCandidate *candidate,
+    const LocationRecord *location,
+    double confidence,
+    const char *strategy,
+    const char *reason,
+    const ComponentScores *scores);
+static int candidate_weaker(const MatchResult *result, size_t left_slot, size_t right_slot);
+static void candidate_heap_swap(MatchResult *result, size_t left, size_t right);
+static void candidate_heap_sift_up(MatchResult *result, size_t position);
+static void candidate_heap_sift_down(MatchResult *result, size_t position);
 static int compare_candidates(const void *lhs, const void *rhs);
 static void strategy_canonical(
-    const AddressComponents *query,
+    ScoringContext *context,
     const LocationStore *store,
     const MatcherConfig *config,
     MatchResult *result);
-static void strategy_structured(
-    const AddressComponents *query,
+static void strategy_block(
+    ScoringContext *context,
     const LocationStore *store,
+    const CandidateBlock *block,
     const MatcherConfig *config,
     MatchResult *result);
-static void strategy_fuzzy(
-    const AddressComponents *query,
+static void prefetch_block_chunk(
+    ScoringContext *context,
     const LocationStore *store,
+    const CandidateBlock *block,
+    size_t start,
+    const MatcherConfig *config,
+    double floor,
+    double *exact_scores);
+static void strategy_block_partitioned(
+    ScoringContext *context,
+    const LocationStore *store,
+    const CandidateBlock *block,
     const MatcherConfig *config,
     MatchResult *result);
+static void *scan_partition(void *arg);
+static uint64_t monotonic_ns(void);
+static long budget_remaining_ms(const ScoringContext *context);
+static int canonical_result_settled(const MatchResult *result, const MatcherConfig *config);
+static double exact_component_score(const AddressComponents *left, const AddressComponents *right);
+static double candidate_admission_floor(const MatchResult *result, const MatcherConfig *config);
+static int block_record_admissible(
+    double exact_score,
+    double name_bound,
+    double city_bound,
+    const MatcherConfig *config,
+    double floor);
+static double required_similarity(
+    double exact_score,
+    double name_similarity,
+    const MatcherConfig *config,
+    double floor);
 static void strategy_llm(
     const char *raw_address,
+    ScoringContext *context,
     const LocationStore *store,
     const MatcherConfig *config,
     MatchResult *result);
-static const LocationRecord *find_location_by_id(
-    const LocationStore *store,
-    const char *location_id);
-
-static const char *STATE_CODES[] = {
-    "AL", "AK", "AZ", "AR", "CA", "CO", "CT", "DE", "FL", "GA", "HI", "ID", "IL", "IN", "IA", "KS",
-    "KY", "LA", "ME", "MD", "MA", "MI", "MN", "MS", "MO", "MT", "NE", "NV", "NH", "NJ", "NM", "NY",
-    "NC", "ND", "OH", "OK", "OR", "PA", "RI", "SC", "SD", "TN", "TX", "UT", "VT", "VA", "WA", "WV",
-    "WI", "WY", "DC"};
-
-static const Replacement EXPANSIONS[] = {
+static int llm_result_ambiguous(const MatchResult *result, const MatcherConfig *config);
+static uint64_t llm_query_key(const AddressComponents *components);
+static uint64_t location_store_fingerprint(const LocationStore *store);
+static int parse_llm_response(const char *response, char *location_id, size_t location_id_size, double *confidence);
+static const char *llm_response_field(const char *response, const char *name, size_t *length);
+static void json_escape(char *dest, size_t dest_size, const char *src);
+
+static const RewriteRule EXPANSIONS[] = {
     {" ST ", " STREET "},      {" ST.", " STREET"},      {" AVE ", " AVENUE "},
     {" AVE.", " AVENUE"},      {" RD ", " ROAD "},       {" RD.", " ROAD"},
     {" BLVD ", " BOULEVARD "}, {" BLVD.", " BOULEVARD"}, {" DR ", " DRIVE "},
@@ -113,7 +302,7 @@ static const Replacement EXPANSIONS[] = {
     {" W ", " WEST "},         {" NE ", " NORTHEAST "},  {" NW ", " NORTHWEST "},
     {" SE ", " SOUTHEAST "},   {" SW ", " SOUTHWEST "}};
 
-static const Replacement NUMBERED_STREETS[] = {
+static const RewriteRule NUMBERED_STREETS[] = {
     {" 1ST ", " FIRST "},     {" 2ND ", " SECOND "},         {" 3RD ", " THIRD "},
     {" 4TH ", " FOURTH "},    {" 5TH ", " FIFTH "},          {" 6TH ", " SIXTH "},
     {" 7TH ", " SEVENTH "},   {" 8TH ", " EIGHTH "},         {" 9TH ", " NINTH "},
@@ -151,25 +340,18 @@ static const Replacement NUMBERED_STREETS[] = {
     {" 49TH ", " FORTY-NINTH "},
     {" 50TH ", " FIFTIETH "}};
 
-static const TokenMapping DIRECTIONAL_MAP[] = {
-    {"N", "N"},         {"NORTH", "N"},   {"S", "S"},          {"SOUTH", "S"},
-    {"E", "E"},         {"EAST", "E"},    {"W", "W"},          {"WEST", "W"},
-    {"NE", "NE"},       {"NORTHEAST", "NE"}, {"NW", "NW"},     {"NORTHWEST", "NW"},
-    {"SE", "SE"},       {"SOUTHEAST", "SE"}, {"SW", "SW"},     {"SOUTHWEST", "SW"}};
-
-static const char *PRIMARY_SUFFIXES[] = {
-    "ALLEY",   "ALLY",   "AVENUE", "AVE", "BEND",   "BLVD", "BOULEVARD", "CIRCLE",
-    "CIR",     "COURT",  "CT",     "DRIVE", "DR",   "FREEWAY", "FWY",    "HIGHWAY",
-    "HWY",     "LANE",   "LN",     "LOOP", "PARKWAY", "PKWY", "PLACE",  "PL",
-    "ROAD",    "RD",     "STREET", "ST",  "TERRACE", "TER",   "TRAIL",  "TRL",
-    "WAY"};
-
-static const char *UNIT_TOKENS[] = {
-    "APT",  "APARTMENT", "UNIT",   "STE",   "SUITE", "#",     "RM",
-    "ROOM", "FLOOR",     "FL",     "LEVEL", "BLDG",  "BUILDING"};
-
 static const double WEIGHTS[] = {0.35, 0.25, 0.05, 0.05, 0.15, 0.05, 0.10};
 
+static TextRewriter address_rewriter;
+static pthread_once_t address_rewriter_once = PTHREAD_ONCE_INIT;
+static NormalizationRules loaded_rules;
+static int rules_loaded;
+static LlmPool llm_pool;
+static LlmCache llm_cache;
+static atomic_ullong llm_invoked_count;
+static atomic_ullong llm_skipped_count;
+static atomic_ullong llm_cache_hit_count;
+
 int location_store_init(LocationStore *store) {
     if (store == NULL) {
         return -1;
@@ -177,6 +359,24 @@ int location_store_init(LocationStore *store) {
     store->items = NULL;
     store->count = 0;
     store->capacity = 0;
+    string_dictionary_init(&store->street_names);
+    string_dictionary_init(&store->cities);
+    key_index_init(&store->canonical_index);
+    key_index_init(&store->id_index);
+    key_index_init(&store->postal_number_index);
+    key_index_init(&store->city_number_index);
+    key_index_init(&store->postal_index);
+    key_index_init(&store->city_index);
+    key_index_init(&store->street_index);
+    key_index_init(&store->state_street_index);
+    trigram_index_init(&store->street_trigrams);
+    bk_tree_init(&store->street_name_tree);
+    bk_tree_init(&store->city_tree);
+    key_index_init(&store->street_phonetic_index);
+    key_index_init(&store->city_phonetic_index);
+    store->json_fragments = NULL;
+    store->json_offsets = NULL;
+    placement_arena_init(&store->placement);
     return 0;
 }
 
@@ -184,10 +384,34 @@ void location_store_free(LocationStore *store) {
     if (store == NULL) {
         return;
     }
+    if (store->placement.base != NULL) {
+        placement_arena_release(&store->placement);
+        location_store_init(store);
+        return;
+    }
     free(store->items);
     store->items = NULL;
     store->count = 0;
     store->capacity = 0;
+    string_dictionary_free(&store->street_names);
+    string_dictionary_free(&store->cities);
+    key_index_free(&store->canonical_index);
+    key_index_free(&store->id_index);
+    key_index_free(&store->postal_number_index);
+    key_index_free(&store->city_number_index);
+    key_index_free(&store->postal_index);
+    key_index_free(&store->city_index);
+    key_index_free(&store->street_index);
+    key_index_free(&store->state_street_index);
+    trigram_index_free(&store->street_trigrams);
+    bk_tree_free(&store->street_name_tree);
+    bk_tree_free(&store->city_tree);
+    key_index_free(&store->street_phonetic_index);
+    key_index_free(&store->city_phonetic_index);
+    free(store->json_fragments);
+    free(store->json_offsets);
+    store->json_fragments = NULL;
+    store->json_offsets = NULL;
 }
 
 int location_store_load(LocationStore *store, const char *connection_uri) {
@@ -248,6 +472,7 @@ int location_store_load(LocationStore *store, const char *connection_uri) {
 
         LocationRecord *record = &store->items[store->count];
         copy_field(record->location_id, sizeof(record->location_id), location_code);
+        record->id_fingerprint = ams_fingerprint(record->location_id);
         copy_field(record->street, sizeof(record->street), street);
         copy_field(record->city, sizeof(record->city), city);
         copy_field(record->state, sizeof(record->state), state);
@@ -274,14 +499,147 @@ int location_store_load(LocationStore *store, const char *connection_uri) {
             record->postal_code);
 
         parse_address(composite, &record->components);
+        if (string_dictionary_intern(&store->street_names, record->components.street_name, &record->street_name_id) != 0 ||
+            string_dictionary_intern(&store->cities, record->components.city, &record->city_id) != 0) {
+            PQclear(result);
+            PQfinish(conn);
+            return -1;
+        }
         ++store->count;
     }
 
     PQclear(result);
     PQfinish(conn);
+    if (location_store_build_indexes(store) != 0) {
+        return -1;
+    }
+    return location_store_build_json(store);
+}
+
+int location_store_replicate(const LocationStore *source, LocationStore *replica, int huge_pages) {
+    if (source == NULL || replica == NULL) {
+        return -1;
+    }
+
+    int failed = 0;
+    PlacementArena arena;
+    placement_arena_init(&arena);
+    location_store_copy(source, replica, &arena, &failed);
+    if (placement_arena_map(&arena, arena.used, huge_pages) != 0) {
+        location_store_init(replica);
+        return -1;
+    }
+    location_store_copy(source, replica, &arena, &failed);
+    replica->placement = arena;
+    if (failed) {
+        location_store_free(replica);
+        return -1;
+    }
+    return 0;
+}
+
+const LocationRecord *location_store_find(const LocationStore *store, const char *location_id) {
+    if (store == NULL || location_id == NULL || location_id[0] == '\0') {
+        return NULL;
+    }
+    size_t match_count = 0;
+    const uint32_t *matches = key_index_lookup(&store->id_index, ams_fingerprint(location_id), &match_count);
+    for (size_t i = 0; i < match_count; ++i) {
+        const LocationRecord *location = &store->items[matches[i]];
+        if (strcmp(location->location_id, location_id) == 0) {
+            return location;
+        }
+    }
+    return NULL;
+}
+
+const char *location_store_json_id(const LocationStore *store, const LocationRecord *location, size_t *length) {
+    if (store == NULL || location == NULL || store->json_offsets == NULL || length == NULL) {
+        return NULL;
+    }
+    size_t index = (size_t)(location - store->items) * 2;
+    *length = store->json_offsets[index + 1] - store->json_offsets[index];
+    return store->json_fragments + store->json_offsets[index];
+}
+
+const char *location_store_json_address(const LocationStore *store, const LocationRecord *location, size_t *length) {
+    if (store == NULL || location == NULL || store->json_offsets == NULL || length == NULL) {
+        return NULL;
+    }
+    size_t index = (size_t)(location - store->items) * 2 + 1;
+    *length = store->json_offsets[index + 1] - store->json_offsets[index];
+    return store->json_fragments + store->json_offsets[index];
+}
+
+int matcher_load_rules(const char *path, char *error, size_t error_size) {
+    NormalizationRules rules;
+    normalization_rules_init(&rules);
+    if (normalization_rules_load(&rules, path, error, error_size) != 0) {
+        return -1;
+    }
+
+    TextRewriter rewriter;
+    text_rewriter_init(&rewriter);
+    if (text_rewriter_build(&rewriter, rules.rewrites, rules.rewrite_count) != 0) {
+        if (error != NULL) {
+            snprintf(error, error_size, "%s: unable to compile rewrite rules", path);
+        }
+        normalization_rules_free(&rules);
+        return -1;
+    }
+
+    pthread_once(&address_rewriter_once, build_address_rewriter);
+    text_rewriter_free(&address_rewriter);
+    address_rewriter = rewriter;
+    normalization_rules_free(&loaded_rules);
+    loaded_rules = rules;
+    rules_loaded = 1;
+    return 0;
+}
+
+const char *matcher_rules_version(void) {
+    return rules_loaded ? loaded_rules.version : "builtin";
+}
+
+int matcher_start_llm(const MatcherConfig *config, const LocationStore *store) {
+    if (config == NULL || !config->llm_enabled || config->llm_command[0] == '\0') {
+        return 0;
+    }
+    matcher_stop_llm();
+    if (llm_cache_open(
+            &llm_cache,
+            config->llm_cache_path,
+            config->llm_cache_size,
+            location_store_fingerprint(store)) != 0) {
+        return -1;
+    }
+    if (llm_pool_start(
+            &llm_pool,
+            config->llm_command,
+            config->llm_workers,
+            config->llm_timeout_ms,
+            config->llm_batch_size,
+            config->llm_batch_linger_ms) != 0) {
+        llm_cache_close(&llm_cache);
+        return -1;
+    }
     return 0;
 }
 
+void matcher_stop_llm(void) {
+    llm_pool_stop(&llm_pool);
+    llm_cache_close(&llm_cache);
+}
+
+void matcher_stats_snapshot(MatcherStats *stats) {
+    if (stats == NULL) {
+        return;
+    }
+    stats->llm_invoked = atomic_load_explicit(&llm_invoked_count, memory_order_relaxed);
+    stats->llm_skipped = atomic_load_explicit(&llm_skipped_count, memory_order_relaxed);
+    stats->llm_cache_hits = atomic_load_explicit(&llm_cache_hit_count, memory_order_relaxed);
+}
+
 int parse_address(const char *input, AddressComponents *out) {
     if (out == NULL) {
         return -1;
@@ -294,35 +652,22 @@ int parse_address(const char *input, AddressComponents *out) {
     char expanded[AMS_MAX_LINE_LENGTH];
     expand_address_text(input, expanded, sizeof(expanded));
 
-    char buffer[AMS_MAX_LINE_LENGTH];
-    copy_field(buffer, sizeof(buffer), expanded);
-    uppercase_inplace(buffer);
-
-    char tokens[AMS_MAX_TOKENS][AMS_MAX_FIELD_LENGTH];
+    TokenSpan tokens[AMS_MAX_TOKENS];
     int active[AMS_MAX_TOKENS] = {0};
-    size_t token_count = 0;
-
-    char *token = strtok(buffer, " ,");
-    while (token != NULL && token_count < AMS_MAX_TOKENS) {
-        trim_whitespace(token);
-        if (*token != '\0') {
-            copy_field(tokens[token_count], sizeof(tokens[token_count]), token);
-            active[token_count] = 1;
-            ++token_count;
-        }
-        token = strtok(NULL, " ,");
-    }
-
+    size_t token_count = tokenize_address(expanded, tokens, AMS_MAX_TOKENS);
     if (token_count == 0) {
         return -1;
     }
+    for (size_t idx = 0; idx < token_count; ++idx) {
+        active[idx] = 1;
+    }
 
     for (ssize_t idx = (ssize_t)token_count - 1; idx >= 0; --idx) {
         if (!active[idx]) {
             continue;
         }
-        if (is_zip_code(tokens[idx])) {
-            copy_field(out->postal_code, sizeof(out->postal_code), tokens[idx]);
+        if (is_zip_code(&tokens[idx])) {
+            copy_span(out->postal_code, sizeof(out->postal_code), &tokens[idx]);
             canonicalize_zip(out->postal_code);
             active[idx] = 0;
             break;
@@ -333,9 +678,7 @@ int parse_address(const char *input, AddressComponents *out) {
         if (!active[idx]) {
             continue;
         }
-        const char *state = normalize_state(tokens[idx]);
-        if (state != NULL && state[0] != '\0') {
-            copy_field(out->state, sizeof(out->state), state);
+        if (normalize_state(&tokens[idx], out->state, sizeof(out->state))) {
             active[idx] = 0;
             break;
         }
@@ -346,43 +689,31 @@ int parse_address(const char *input, AddressComponents *out) {
         if (!active[idx]) {
             continue;
         }
-        if (is_unit_token(tokens[idx])) {
-            unit_index = idx;
-            break;
-        }
-        if (tokens[idx][0] == '#') {
+        if ((tokens[idx].kinds & AMS_KEYWORD_UNIT) || tokens[idx].start[0] == '#') {
             unit_index = idx;
             break;
         }
     }
 
     if (unit_index != SIZE_MAX) {
-        size_t write_index = 0;
         for (size_t idx = unit_index; idx < token_count && active[idx]; ++idx) {
-            copy_field(out->unit + write_index, sizeof(out->unit) - write_index, tokens[idx]);
-            write_index = strlen(out->unit);
-            if (write_index + 1 < sizeof(out->unit)) {
-                out->unit[write_index++] = ' ';
-                out->unit[write_index] = '\0';
-            }
+            append_span(out->unit, sizeof(out->unit), tokens[idx].start, tokens[idx].length);
+            append_span(out->unit, sizeof(out->unit), " ", 1);
             active[idx] = 0;
-            if (idx + 1 >= token_count || !active[idx + 1] || !is_unit_followup(tokens[idx + 1])) {
+            if (idx + 1 >= token_count || !active[idx + 1] || !is_unit_followup(&tokens[idx + 1])) {
                 break;
             }
         }
         trim_whitespace(out->unit);
-        uppercase_inplace(out->unit);
     }
 
     for (size_t idx = 0; idx < token_count; ++idx) {
         if (!active[idx]) {
             continue;
         }
-        if (extract_house_number(tokens[idx], out->street_number, sizeof(out->street_number))) {
-            if (tokens[idx][0] == '\0') {
+        if (extract_house_number(&tokens[idx], out->street_number, sizeof(out->street_number))) {
+            if (tokens[idx].length == 0) {
                 active[idx] = 0;
-            } else {
-                copy_field(tokens[idx], sizeof(tokens[idx]), tokens[idx]);
             }
             break;
         }
@@ -392,12 +723,15 @@ int parse_address(const char *input, AddressComponents *out) {
         if (!active[idx]) {
             continue;
         }
-        const char *direction = normalize_direction(tokens[idx]);
-        if (direction != NULL && direction[0] != '\0') {
-            copy_field(out->street_direction, sizeof(out->street_direction), direction);
-            active[idx] = 0;
-            break;
+        const ParserKeyword *keyword = (tokens[idx].kinds & AMS_KEYWORD_DIRECTION)
+                                           ? lookup_keyword(tokens[idx].start, tokens[idx].length)
+                                           : NULL;
+        if (keyword != NULL) {
+            copy_field(out->street_direction, sizeof(out->street_direction), keyword->canonical);
+        } else {
+            copy_span(out->street_direction, sizeof(out->street_direction), &tokens[idx]);
         }
+        active[idx] = 0;
         break;
     }
 
@@ -406,43 +740,36 @@ int parse_address(const char *input, AddressComponents *out) {
         if (!active[idx]) {
             continue;
         }
-        if (is_primary_suffix(tokens[idx])) {
+        if (tokens[idx].kinds & AMS_KEYWORD_SUFFIX) {
             suffix_index = (ssize_t)idx;
-            copy_field(out->street_suffix, sizeof(out->street_suffix), tokens[idx]);
+            copy_span(out->street_suffix, sizeof(out->street_suffix), &tokens[idx]);
             active[idx] = 0;
             break;
         }
     }
 
-    char street_buffer[AMS_MAX_FIELD_LENGTH] = {0};
-    char city_buffer[AMS_MAX_FIELD_LENGTH] = {0};
-
     for (size_t idx = 0; idx < token_count; ++idx) {
         if (!active[idx]) {
             continue;
         }
 
         if (suffix_index >= 0 && (ssize_t)idx > suffix_index) {
-            if (city_buffer[0] != '\0') {
-                strncat(city_buffer, " ", sizeof(city_buffer) - strlen(city_buffer) - 1);
+            if (out->city[0] != '\0') {
+                append_span(out->city, sizeof(out->city), " ", 1);
             }
-            strncat(city_buffer, tokens[idx], sizeof(city_buffer) - strlen(city_buffer) - 1);
+            append_span(out->city, sizeof(out->city), tokens[idx].start, tokens[idx].length);
         } else {
-            char normalized[AMS_MAX_FIELD_LENGTH];
-            copy_field(normalized, sizeof(normalized), tokens[idx]);
-            normalize_ordinal_token(normalized);
-            if (street_buffer[0] != '\0') {
-                strncat(street_buffer, " ", sizeof(street_buffer) - strlen(street_buffer) - 1);
+            if (out->street_name[0] != '\0') {
+                append_span(out->street_name, sizeof(out->street_name), " ", 1);
             }
-            strncat(street_buffer, normalized, sizeof(street_buffer) - strlen(street_buffer) - 1);
+            append_span(
+                out->street_name,
+                sizeof(out->street_name),
+                tokens[idx].start,
+                ordinal_token_length(&tokens[idx]));
         }
     }
 
-    copy_field(out->street_name, sizeof(out->street_name), street_buffer);
-    uppercase_inplace(out->street_name);
-    copy_field(out->city, sizeof(out->city), city_buffer);
-    uppercase_inplace(out->city);
-
     compute_canonical_key(out);
     return 0;
 }
@@ -454,9 +781,21 @@ void matcher_config_init(MatcherConfig *config) {
     config->structured_min_confidence = AMS_DEFAULT_STRUCTURED_THRESHOLD;
     config->fuzzy_min_confidence = AMS_DEFAULT_FUZZY_THRESHOLD;
     config->llm_min_confidence = AMS_DEFAULT_LLM_THRESHOLD;
+    config->llm_margin_delta = AMS_DEFAULT_LLM_MARGIN;
+    config->llm_uncertain_min = AMS_DEFAULT_LLM_UNCERTAIN_MIN;
+    config->llm_uncertain_max = AMS_DEFAULT_LLM_UNCERTAIN_MAX;
     config->max_candidates = AMS_DEFAULT_MAX_CANDIDATES;
+    config->scan_threads = AMS_DEFAULT_SCAN_THREADS;
+    config->parallel_scan_min_block = AMS_DEFAULT_PARALLEL_SCAN_MIN_BLOCK;
     config->llm_enabled = 0;
     config->llm_command[0] = '\0';
+    config->llm_workers = AMS_DEFAULT_LLM_WORKERS;
+    config->llm_timeout_ms = AMS_DEFAULT_LLM_TIMEOUT_MS;
+    config->llm_cache_size = AMS_DEFAULT_LLM_CACHE_SIZE;
+    config->llm_batch_size = AMS_DEFAULT_LLM_BATCH_SIZE;
+    config->llm_batch_linger_ms = AMS_DEFAULT_LLM_BATCH_LINGER_MS;
+    config->request_budget_ms = AMS_DEFAULT_REQUEST_BUDGET_MS;
+    config->llm_cache_path[0] = '\0';
 
     const char *structured_env = getenv("AMS_STRUCTURED_THRESHOLD");
     if (structured_env && structured_env[0] != '\0') {
@@ -482,6 +821,30 @@ void matcher_config_init(MatcherConfig *config) {
         }
     }
 
+    const char *llm_margin_env = getenv("AMS_LLM_MARGIN");
+    if (llm_margin_env && llm_margin_env[0] != '\0') {
+        double value = atof(llm_margin_env);
+        if (value >= 0.0 && value <= 1.0) {
+            config->llm_margin_delta = value;
+        }
+    }
+
+    const char *llm_uncertain_min_env = getenv("AMS_LLM_UNCERTAIN_MIN");
+    if (llm_uncertain_min_env && llm_uncertain_min_env[0] != '\0') {
+        double value = atof(llm_uncertain_min_env);
+        if (value >= 0.0 && value <= 1.0) {
+            config->llm_uncertain_min = value;
+        }
+    }
+
+    const char *llm_uncertain_max_env = getenv("AMS_LLM_UNCERTAIN_MAX");
+    if (llm_uncertain_max_env && llm_uncertain_max_env[0] != '\0') {
+        double value = atof(llm_uncertain_max_env);
+        if (value >= 0.0 && value <= 1.0) {
+            config->llm_uncertain_max = value;
+        }
+    }
+
     const char *max_candidates_env = getenv("AMS_MAX_CANDIDATES");
     if (max_candidates_env && max_candidates_env[0] != '\0') {
         int ivalue = atoi(max_candidates_env);
@@ -490,11 +853,80 @@ void matcher_config_init(MatcherConfig *config) {
         }
     }
 
+    const char *scan_threads_env = getenv("AMS_SCAN_THREADS");
+    if (scan_threads_env && scan_threads_env[0] != '\0') {
+        int ivalue = atoi(scan_threads_env);
+        if (ivalue > 0 && ivalue <= AMS_MAX_SCAN_THREADS) {
+            config->scan_threads = (size_t)ivalue;
+        }
+    }
+
+    const char *scan_min_env = getenv("AMS_SCAN_PARALLEL_MIN");
+    if (scan_min_env && scan_min_env[0] != '\0') {
+        long lvalue = atol(scan_min_env);
+        if (lvalue > 0) {
+            config->parallel_scan_min_block = (size_t)lvalue;
+        }
+    }
+
     const char *llm_command = getenv("AMS_LLM_COMMAND");
     if (llm_command && llm_command[0] != '\0') {
         copy_field(config->llm_command, sizeof(config->llm_command), llm_command);
         config->llm_enabled = 1;
     }
+
+    const char *llm_workers_env = getenv("AMS_LLM_WORKERS");
+    if (llm_workers_env && llm_workers_env[0] != '\0') {
+        int ivalue = atoi(llm_workers_env);
+        if (ivalue > 0 && ivalue <= AMS_LLM_POOL_MAX_WORKERS) {
+            config->llm_workers = (size_t)ivalue;
+        }
+    }
+
+    const char *llm_timeout_env = getenv("AMS_LLM_TIMEOUT_MS");
+    if (llm_timeout_env && llm_timeout_env[0] != '\0') {
+        int ivalue = atoi(llm_timeout_env);
+        if (ivalue > 0) {
+            config->llm_timeout_ms = ivalue;
+        }
+    }
+
+    const char *budget_env = getenv("AMS_REQUEST_BUDGET_MS");
+    if (budget_env && budget_env[0] != '\0') {
+        int ivalue = atoi(budget_env);
+        if (ivalue >= 0) {
+            config->request_budget_ms = ivalue;
+        }
+    }
+
+    const char *llm_batch_size_env = getenv("AMS_LLM_BATCH_SIZE");
+    if (llm_batch_size_env && llm_batch_size_env[0] != '\0') {
+        int ivalue = atoi(llm_batch_size_env);
+        if (ivalue > 0 && ivalue <= AMS_LLM_POOL_MAX_BATCH) {
+            config->llm_batch_size = (size_t)ivalue;
+        }
+    }
+
+    const char *llm_linger_env = getenv("AMS_LLM_BATCH_LINGER_MS");
+    if (llm_linger_env && llm_linger_env[0] != '\0') {
+        int ivalue = atoi(llm_linger_env);
+        if (ivalue >= 0) {
+            config->llm_batch_linger_ms = ivalue;
+        }
+    }
+
+    const char *llm_cache_size_env = getenv("AMS_LLM_CACHE_SIZE");
+    if (llm_cache_size_env && llm_cache_size_env[0] != '\0') {
+        long lvalue = atol(llm_cache_size_env);
+        if (lvalue >= 0) {
+            config->llm_cache_size = (size_t)lvalue;
+        }
+    }
+
+    const char *llm_cache_path = getenv("AMS_LLM_CACHE_FILE");
+    if (llm_cache_path && llm_cache_path[0] != '\0') {
+        copy_field(config->llm_cache_path, sizeof(config->llm_cache_path), llm_cache_path);
+    }
 }
 
 void match_record(
@@ -512,6 +944,7 @@ void match_record(
         config = &local_config;
     }
 
+    uint64_t started_ns = monotonic_ns();
     match_result_init(result);
     if (raw_address) {
         copy_field(result->raw_address, sizeof(result->raw_address), raw_address);
@@ -523,14 +956,38 @@ void match_record(
         return;
     }
 
-    strategy_canonical(&result->record_components, store, config, result);
-    strategy_structured(&result->record_components, store, config, result);
-    strategy_fuzzy(&result->record_components, store, config, result);
-    strategy_llm(raw_address, store, config, result);
+    ScoringContext context;
+    scoring_context_init(&context, &result->record_components, store);
+    if (config->request_budget_ms > 0) {
+        context.deadline_ns = started_ns + (uint64_t)config->request_budget_ms * 1000000ULL;
+    }
+    strategy_canonical(&context, store, config, result);
+    for (int tier = 0; tier < BLOCK_TIER_COUNT && !canonical_result_settled(result, config); ++tier) {
+        if (budget_remaining_ms(&context) == 0) {
+            result->degraded = 1;
+            break;
+        }
+        CandidateBlock block;
+        if (collect_block(&result->record_components, store, config, (BlockTier)tier, &block) != 0) {
+            continue;
+        }
+        strategy_block_partitioned(&context, store, &block, config, result);
+        candidate_block_free(&block);
+        if (result->count > 0) {
+            break;
+        }
+    }
+    strategy_llm(raw_address, &context, store, config, result);
+    scoring_context_free(&context);
 
     if (result->count > 1) {
         qsort(result->items, result->count, sizeof(MatchCandidate), compare_candidates);
     }
+    for (size_t slot = 0; slot < result->count; ++slot) {
+        result->candidate_keys[slot] = result->items[slot].location->id_fingerprint;
+        result->heap[result->count - 1 - slot] = (uint8_t)slot;
+        result->heap_positions[slot] = (uint8_t)(result->count - 1 - slot);
+    }
 
     if (result->count > 0) {
         result->has_best_candidate = 1;
@@ -568,74 +1025,608 @@ static int ensure_capacity(LocationStore *store, size_t required) {
     return 0;
 }
 
-static void copy_field(char *dest, size_t dest_size, const char *src) {
-    if (dest == NULL || dest_size == 0) {
-        return;
+static int location_store_build_json(LocationStore *store) {
+    free(store->json_fragments);
+    free(store->json_offsets);
+    store->json_fragments = NULL;
+    store->json_offsets = NULL;
+
+    store->json_offsets = malloc((store->count * 2 + 1) * sizeof(uint32_t));
+    if (store->json_offsets == NULL) {
+        return -1;
     }
-    if (src == NULL) {
-        dest[0] = '\0';
-        return;
+
+    size_t length = 0;
+    size_t capacity = 0;
+    char fragment[AMS_JSON_FRAGMENT_LENGTH];
+    for (size_t i = 0; i <= store->count * 2; ++i) {
+        if (length > UINT32_MAX) {
+            return -1;
+        }
+        store->json_offsets[i] = (uint32_t)length;
+        if (i == store->count * 2) {
+            break;
+        }
+
+        const LocationRecord *record = &store->items[i / 2];
+        JsonWriter writer;
+        json_writer_init(&writer, fragment, sizeof(fragment));
+        if (i % 2 == 0) {
+            json_writer_append_escaped(&writer, record->location_id, AMS_MAX_FIELD_LENGTH - 1);
+        } else {
+            append_json_field(&writer, "\"street\": \"", record->street);
+            append_json_field(&writer, "\", \"city\": \"", record->city);
+            append_json_field(&writer, "\", \"state\": \"", record->state);
+            append_json_field(&writer, "\", \"postal_code\": \"", record->postal_code);
+            json_writer_append_raw(&writer, "\"");
+        }
+
+        if (length + writer.length + 1 > capacity) {
+            size_t new_capacity = capacity == 0 ? AMS_JSON_FRAGMENT_LENGTH * 64 : capacity * 2;
+            while (new_capacity < length + writer.length + 1) {
+                new_capacity *= 2;
+            }
+            char *grown = realloc(store->json_fragments, new_capacity);
+            if (grown == NULL) {
+                return -1;
+            }
+            store->json_fragments = grown;
+            capacity = new_capacity;
+        }
+        memcpy(store->json_fragments + length, fragment, writer.length);
+        length += writer.length;
     }
-    size_t length = strlen(src);
-    if (length >= dest_size) {
-        length = dest_size - 1;
+    return 0;
+}
+
+static void append_json_field(JsonWriter *writer, const char *prefix, const char *value) {
+    json_writer_append_raw(writer, prefix);
+    json_writer_append_escaped(writer, value, AMS_MAX_FIELD_LENGTH - 1);
+}
+
+static void location_store_copy(const LocationStore *source, LocationStore *replica, PlacementArena *arena, int *failed) {
+    *replica = *source;
+    placement_arena_init(&replica->placement);
+    replica->items = placement_copy(arena, source->items, source->count * sizeof(LocationRecord), failed);
+    replica->capacity = source->count;
+    string_dictionary_copy(&source->street_names, &replica->street_names, arena, failed);
+    string_dictionary_copy(&source->cities, &replica->cities, arena, failed);
+    key_index_copy(&source->canonical_index, &replica->canonical_index, arena, failed);
+    key_index_copy(&source->id_index, &replica->id_index, arena, failed);
+    key_index_copy(&source->postal_number_index, &replica->postal_number_index, arena, failed);
+    key_index_copy(&source->city_number_index, &replica->city_number_index, arena, failed);
+    key_index_copy(&source->postal_index, &replica->postal_index, arena, failed);
+    key_index_copy(&source->city_index, &replica->city_index, arena, failed);
+    key_index_copy(&source->street_index, &replica->street_index, arena, failed);
+    key_index_copy(&source->state_street_index, &replica->state_street_index, arena, failed);
+    key_index_copy(&source->street_trigrams.grams, &replica->street_trigrams.grams, arena, failed);
+    replica->street_trigrams.gram_counts = placement_copy(
+        arena,
+        source->street_trigrams.gram_counts,
+        source->street_trigrams.name_count * sizeof(uint16_t),
+        failed);
+    replica->street_name_tree.nodes = placement_copy(
+        arena,
+        source->street_name_tree.nodes,
+        source->street_name_tree.node_count * sizeof(BkTreeNode),
+        failed);
+    replica->city_tree.nodes =
+        placement_copy(arena, source->city_tree.nodes, source->city_tree.node_count * sizeof(BkTreeNode), failed);
+    key_index_copy(&source->street_phonetic_index, &replica->street_phonetic_index, arena, failed);
+    key_index_copy(&source->city_phonetic_index, &replica->city_phonetic_index, arena, failed);
+    if (source->json_offsets != NULL) {
+        replica->json_fragments =
+            placement_copy(arena, source->json_fragments, source->json_offsets[source->count * 2], failed);
+        replica->json_offsets =
+            placement_copy(arena, source->json_offsets, (source->count * 2 + 1) * sizeof(uint32_t), failed);
     }
-    memcpy(dest, src, length);
-    dest[length] = '\0';
 }
 
-static void uppercase_inplace(char *value) {
-    if (value == NULL) {
-        return;
+static void string_dictionary_copy(
+    const StringDictionary *source,
+    StringDictionary *replica,
+    PlacementArena *arena,
+    int *failed) {
+    *replica = *source;
+    replica->arena = placement_copy(arena, source->arena, source->arena_length, failed);
+    replica->arena_capacity = source->arena_length;
+    replica->offsets = placement_copy(arena, source->offsets, source->count * sizeof(uint32_t), failed);
+    replica->hashes = placement_copy(arena, source->hashes, source->count * sizeof(uint64_t), failed);
+    replica->capacity = source->count;
+    replica->slots = placement_copy(arena, source->slots, source->slot_count * sizeof(uint32_t), failed);
+}
+
+static void key_index_copy(const KeyIndex *source, KeyIndex *replica, PlacementArena *arena, int *failed) {
+    *replica = *source;
+    replica->slots = placement_copy(arena, source->slots, source->slot_count * sizeof(KeyIndexSlot), failed);
+    replica->postings = placement_copy(arena, source->postings, source->posting_count * sizeof(uint32_t), failed);
+}
+
+static void *placement_copy(PlacementArena *arena, const void *data, size_t size, int *failed) {
+    if (data == NULL || size == 0) {
+        return NULL;
     }
-    for (size_t i = 0; value[i] != '\0'; ++i) {
-        value[i] = (char)toupper((unsigned char)value[i]);
+    void *copy = placement_arena_copy(arena, data, size);
+    if (copy == NULL && arena->base != NULL) {
+        *failed = 1;
     }
+    return copy;
 }
 
-static void trim_whitespace(char *value) {
-    if (value == NULL) {
-        return;
+static int location_store_build_indexes(LocationStore *store) {
+    if (store->count == 0) {
+        key_index_free(&store->canonical_index);
+        key_index_free(&store->id_index);
+        key_index_free(&store->postal_number_index);
+        key_index_free(&store->city_number_index);
+        key_index_free(&store->postal_index);
+        key_index_free(&store->city_index);
+        key_index_free(&store->street_index);
+        key_index_free(&store->state_street_index);
+        trigram_index_free(&store->street_trigrams);
+        bk_tree_free(&store->street_name_tree);
+        bk_tree_free(&store->city_tree);
+        key_index_free(&store->street_phonetic_index);
+        key_index_free(&store->city_phonetic_index);
+        return 0;
     }
-    size_t length = strlen(value);
-    size_t start = 0;
-    while (start < length && isspace((unsigned char)value[start])) {
-        ++start;
+
+    uint64_t *fingerprints = malloc(store->count * sizeof(uint64_t));
+    if (fingerprints == NULL) {
+        return -1;
     }
-    size_t end = length;
-    while (end > start && isspace((unsigned char)value[end - 1])) {
-        --end;
+
+    for (size_t i = 0; i < store->count; ++i) {
+        fingerprints[i] = ams_fingerprint(store->items[i].components.canonical_key);
     }
-    if (start > 0 || end < length) {
-        memmove(value, value + start, end - start);
+    int status = key_index_build(&store->canonical_index, fingerprints, store->count);
+
+    if (status == 0) {
+        for (size_t i = 0; i < store->count; ++i) {
+            fingerprints[i] = store->items[i].id_fingerprint;
+        }
+        status = key_index_build(&store->id_index, fingerprints, store->count);
     }
-    value[end - start] = '\0';
+    if (status == 0) {
+        status = build_blocking_index(&store->postal_number_index, store, fingerprints, postal_number_key);
+    }
+    if (status == 0) {
+        status = build_blocking_index(&store->city_number_index, store, fingerprints, city_number_key);
+    }
+    if (status == 0) {
+        status = build_blocking_index(&store->postal_index, store, fingerprints, postal_key);
+    }
+    if (status == 0) {
+        status = build_blocking_index(&store->city_index, store, fingerprints, city_key);
+    }
+    if (status == 0) {
+        status = build_blocking_index(&store->street_index, store, fingerprints, street_key);
+    }
+    if (status == 0) {
+        status = build_blocking_index(&store->state_street_index, store, fingerprints, state_street_key);
+    }
+    if (status == 0) {
+        status = trigram_index_build(&store->street_trigrams, &store->street_names);
+    }
+    if (status == 0) {
+        status = bk_tree_build(&store->street_name_tree, &store->street_names);
+    }
+    if (status == 0) {
+        status = bk_tree_build(&store->city_tree, &store->cities);
+    }
+    if (status == 0) {
+        status = build_phonetic_index(&store->street_phonetic_index, &store->street_names);
+    }
+    if (status == 0) {
+        status = build_phonetic_index(&store->city_phonetic_index, &store->cities);
+    }
+
+    free(fingerprints);
+    return status;
 }
 
-static void clear_address_components(AddressComponents *components) {
-    if (components == NULL) {
-        return;
+static int build_blocking_index(
+    KeyIndex *index,
+    const LocationStore *store,
+    uint64_t *fingerprints,
+    uint64_t (*key)(const AddressComponents *components)) {
+    for (size_t i = 0; i < store->count; ++i) {
+        fingerprints[i] = key(&store->items[i].components);
     }
-    memset(components, 0, sizeof(*components));
+    return key_index_build(index, fingerprints, store->count);
 }
 
-static void compute_canonical_key(AddressComponents *components) {
-    if (components == NULL) {
-        return;
+static int build_phonetic_index(KeyIndex *index, const StringDictionary *names) {
+    if (names->count == 0) {
+        key_index_free(index);
+        return 0;
     }
-    if (components->street_number[0] == '\0' || components->street_name[0] == '\0') {
-        components->canonical_key[0] = '\0';
-        return;
+    uint64_t *fingerprints = malloc(names->count * sizeof(uint64_t));
+    if (fingerprints == NULL) {
+        return -1;
     }
-    components->canonical_key[0] = '\0';
-    const char *parts[] = {
-        components->street_number,
-        components->street_direction,
-        components->street_name,
-        components->street_suffix,
-        components->city,
-        components->state,
-        components->postal_code};
+    for (size_t id = 0; id < names->count; ++id) {
+        fingerprints[id] = phonetic_fingerprint(string_dictionary_get(names, (uint32_t)id));
+    }
+    int status = key_index_build(index, fingerprints, names->count);
+    free(fingerprints);
+    return status;
+}
+
+static uint64_t phonetic_fingerprint(const char *value) {
+    char key[AMS_PHONETIC_KEY_LENGTH];
+    if (phonetic_key(value, key, sizeof(key)) == 0) {
+        return 0;
+    }
+    return ams_fingerprint(key);
+}
+
+static int append_phonetic_matches(
+    const KeyIndex *index,
+    const char *value,
+    uint32_t **ids,
+    size_t *count) {
+    size_t match_count = 0;
+    const uint32_t *matches = key_index_lookup(index, phonetic_fingerprint(value), &match_count);
+    if (match_count == 0) {
+        return 0;
+    }
+    uint32_t *copy = malloc(match_count * sizeof(uint32_t));
+    if (copy == NULL) {
+        return -1;
+    }
+    memcpy(copy, matches, match_count * sizeof(uint32_t));
+    return merge_name_ids(ids, count, copy, match_count);
+}
+
+static uint64_t blocking_fingerprint(const char *first, const char *second, const char *third) {
+    const char *parts[] = {first, second, third};
+    uint64_t hash = 0;
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); ++i) {
+        if (parts[i] == NULL) {
+            continue;
+        }
+        if (parts[i][0] == '\0') {
+            return 0;
+        }
+        hash = ams_hash_bytes(hash, parts[i], strlen(parts[i]) + 1);
+    }
+    return hash != 0 ? hash : 1;
+}
+
+static const char *blocking_postal(const AddressComponents *components, char *buffer, size_t buffer_size) {
+    size_t length = 0;
+    while (length < AMS_BLOCK_POSTAL_LENGTH && length + 1 < buffer_size &&
+           isdigit((unsigned char)components->postal_code[length])) {
+        buffer[length] = components->postal_code[length];
+        ++length;
+    }
+    buffer[length] = '\0';
+    return buffer;
+}
+
+static uint64_t postal_number_key(const AddressComponents *components) {
+    char postal[AMS_BLOCK_POSTAL_LENGTH + 1];
+    return blocking_fingerprint(blocking_postal(components, postal, sizeof(postal)), components->street_number, NULL);
+}
+
+static uint64_t city_number_key(const AddressComponents *components) {
+    return blocking_fingerprint(components->state, components->city, components->street_number);
+}
+
+static uint64_t postal_key(const AddressComponents *components) {
+    char postal[AMS_BLOCK_POSTAL_LENGTH + 1];
+    return blocking_fingerprint(blocking_postal(components, postal, sizeof(postal)), NULL, NULL);
+}
+
+static uint64_t city_key(const AddressComponents *components) {
+    return blocking_fingerprint(components->state, components->city, NULL);
+}
+
+static uint64_t street_key(const AddressComponents *components) {
+    return blocking_fingerprint(components->street_name, NULL, NULL);
+}
+
+static uint64_t state_street_key(const AddressComponents *components) {
+    return blocking_fingerprint(components->state, components->street_name, NULL);
+}
+
+static int collect_block(
+    const AddressComponents *query,
+    const LocationStore *store,
+    const MatcherConfig *config,
+    BlockTier tier,
+    CandidateBlock *block) {
+    memset(block, 0, sizeof(*block));
+    if (query == NULL || store == NULL || store->count == 0) {
+        return -1;
+    }
+
+    switch (tier) {
+    case BLOCK_TIER_PRIMARY: {
+        size_t postal_count = 0;
+        size_t city_count = 0;
+        const uint32_t *postal_matches =
+            key_index_lookup(&store->postal_number_index, postal_number_key(query), &postal_count);
+        const uint32_t *city_matches =
+            key_index_lookup(&store->city_number_index, city_number_key(query), &city_count);
+        if (candidate_block_append(block, postal_matches, postal_count) != 0 ||
+            candidate_block_append(block, city_matches, city_count) != 0 ||
+            collect_similar_cities(query, store, config, 1, block) != 0 ||
+            collect_similar_streets(query, store, config, block) != 0) {
+            candidate_block_free(block);
+            return -1;
+        }
+        candidate_block_finalize(block);
+        break;
+    }
+    case BLOCK_TIER_POSTAL:
+        block->indices = key_index_lookup(&store->postal_index, postal_key(query), &block->count);
+        break;
+    case BLOCK_TIER_CITY:
+        if (collect_similar_cities(query, store, config, 0, block) != 0) {
+            candidate_block_free(block);
+            return -1;
+        }
+        if (block->owned == NULL) {
+            block->indices = key_index_lookup(&store->city_index, city_key(query), &block->count);
+        }
+        candidate_block_finalize(block);
+        break;
+    case BLOCK_TIER_FULL_STORE:
+        if (query->street_name[0] != '\0') {
+            return -1;
+        }
+        block->count = store->count;
+        return 0;
+    default:
+        return -1;
+    }
+
+    return block->count > 0 ? 0 : -1;
+}
+
+static int collect_similar_streets(
+    const AddressComponents *query,
+    const LocationStore *store,
+    const MatcherConfig *config,
+    CandidateBlock *block) {
+    uint32_t *names = NULL;
+    size_t name_count = 0;
+    if (trigram_index_search(
+            &store->street_trigrams,
+            &store->street_names,
+            query->street_name,
+            config->fuzzy_min_confidence,
+            &names,
+            &name_count) != 0) {
+        return -1;
+    }
+
+    uint32_t *near_names = NULL;
+    size_t near_count = 0;
+    if (bk_tree_search(
+            &store->street_name_tree,
+            &store->street_names,
+            query->street_name,
+            fuzzy_edit_radius(config, query->street_name),
+            &near_names,
+            &near_count) != 0 ||
+        merge_name_ids(&names, &name_count, near_names, near_count) != 0 ||
+        append_phonetic_matches(&store->street_phonetic_index, query->street_name, &names, &name_count) != 0) {
+        free(names);
+        return -1;
+    }
+
+    size_t before = block->count;
+    int status = 0;
+    for (int scoped = 1; scoped >= 0 && status == 0 && block->count == before; --scoped) {
+        if (scoped && query->state[0] == '\0') {
+            continue;
+        }
+        for (size_t i = 0; i < name_count && status == 0; ++i) {
+            const char *name = string_dictionary_get(&store->street_names, names[i]);
+            size_t match_count = 0;
+            const uint32_t *matches = scoped
+                ? key_index_lookup(&store->state_street_index, blocking_fingerprint(query->state, name, NULL), &match_count)
+                : key_index_lookup(&store->street_index, blocking_fingerprint(name, NULL, NULL), &match_count);
+            status = candidate_block_append(block, matches, match_count);
+        }
+    }
+
+    free(names);
+    return status;
+}
+
+static int collect_similar_cities(
+    const AddressComponents *query,
+    const LocationStore *store,
+    const MatcherConfig *config,
+    int with_number,
+    CandidateBlock *block) {
+    if (query->state[0] == '\0' || (with_number && query->street_number[0] == '\0')) {
+        return 0;
+    }
+
+    uint32_t *names = NULL;
+    size_t name_count = 0;
+    if (bk_tree_search(
+            &store->city_tree,
+            &store->cities,
+            query->city,
+            fuzzy_edit_radius(config, query->city),
+            &names,
+            &name_count) != 0) {
+        return -1;
+    }
+    if (append_phonetic_matches(&store->city_phonetic_index, query->city, &names, &name_count) != 0) {
+        free(names);
+        return -1;
+    }
+
+    int status = 0;
+    for (size_t i = 0; i < name_count && status == 0; ++i) {
+        const char *name = string_dictionary_get(&store->cities, names[i]);
+        size_t match_count = 0;
+        const uint32_t *matches = with_number
+            ? key_index_lookup(
+                  &store->city_number_index,
+                  blocking_fingerprint(query->state, name, query->street_number),
+                  &match_count)
+            : key_index_lookup(&store->city_index, blocking_fingerprint(query->state, name, NULL), &match_count);
+        status = candidate_block_append(block, matches, match_count);
+    }
+
+    free(names);
+    return status;
+}
+
+static int fuzzy_edit_radius(const MatcherConfig *config, const char *value) {
+    double confidence = config->fuzzy_min_confidence;
+    return (int)((1.0 - confidence) / confidence * (double)strlen(value) + 1e-9);
+}
+
+static int merge_name_ids(uint32_t **ids, size_t *count, uint32_t *extra, size_t extra_count) {
+    if (extra_count == 0) {
+        free(extra);
+        return 0;
+    }
+    uint32_t *merged = realloc(*ids, (*count + extra_count) * sizeof(uint32_t));
+    if (merged == NULL) {
+        free(extra);
+        return -1;
+    }
+    memcpy(merged + *count, extra, extra_count * sizeof(uint32_t));
+    free(extra);
+
+    size_t total = *count + extra_count;
+    qsort(merged, total, sizeof(uint32_t), compare_record_indices);
+    size_t unique = 0;
+    for (size_t i = 0; i < total; ++i) {
+        if (unique == 0 || merged[i] != merged[unique - 1]) {
+            merged[unique++] = merged[i];
+        }
+    }
+    *ids = merged;
+    *count = unique;
+    return 0;
+}
+
+static int candidate_block_append(CandidateBlock *block, const uint32_t *indices, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    if (block->count + count > block->capacity) {
+        size_t new_capacity = block->capacity == 0 ? 64 : block->capacity;
+        while (new_capacity < block->count + count) {
+            new_capacity *= 2;
+        }
+        uint32_t *owned = realloc(block->owned, new_capacity * sizeof(uint32_t));
+        if (owned == NULL) {
+            return -1;
+        }
+        block->owned = owned;
+        block->capacity = new_capacity;
+    }
+    memcpy(block->owned + block->count, indices, count * sizeof(uint32_t));
+    block->count += count;
+    block->indices = block->owned;
+    return 0;
+}
+
+static void candidate_block_finalize(CandidateBlock *block) {
+    if (block->owned == NULL || block->count < 2) {
+        return;
+    }
+    qsort(block->owned, block->count, sizeof(uint32_t), compare_record_indices);
+    size_t unique = 1;
+    for (size_t i = 1; i < block->count; ++i) {
+        if (block->owned[i] != block->owned[unique - 1]) {
+            block->owned[unique++] = block->owned[i];
+        }
+    }
+    block->count = unique;
+}
+
+static void candidate_block_free(CandidateBlock *block) {
+    free(block->owned);
+    memset(block, 0, sizeof(*block));
+}
+
+static int compare_record_indices(const void *lhs, const void *rhs) {
+    uint32_t left = *(const uint32_t *)lhs;
+    uint32_t right = *(const uint32_t *)rhs;
+    return (left > right) - (left < right);
+}
+
+static void copy_field(char *dest, size_t dest_size, const char *src) {
+    if (dest == NULL || dest_size == 0) {
+        return;
+    }
+    if (src == NULL) {
+        dest[0] = '\0';
+        return;
+    }
+    size_t length = strlen(src);
+    if (length >= dest_size) {
+        length = dest_size - 1;
+    }
+    memcpy(dest, src, length);
+    dest[length] = '\0';
+}
+
+static void uppercase_inplace(char *value) {
+    if (value == NULL) {
+        return;
+    }
+    for (size_t i = 0; value[i] != '\0'; ++i) {
+        value[i] = (char)toupper((unsigned char)value[i]);
+    }
+}
+
+static void trim_whitespace(char *value) {
+    if (value == NULL) {
+        return;
+    }
+    size_t length = strlen(value);
+    size_t start = 0;
+    while (start < length && isspace((unsigned char)value[start])) {
+        ++start;
+    }
+    size_t end = length;
+    while (end > start && isspace((unsigned char)value[end - 1])) {
+        --end;
+    }
+    if (start > 0 || end < length) {
+        memmove(value, value + start, end - start);
+    }
+    value[end - start] = '\0';
+}
+
+static void clear_address_components(AddressComponents *components) {
+    if (components == NULL) {
+        return;
+    }
+    memset(components, 0, sizeof(*components));
+}
+
+static void compute_canonical_key(AddressComponents *components) {
+    if (components == NULL) {
+        return;
+    }
+    if (components->street_number[0] == '\0' || components->street_name[0] == '\0') {
+        components->canonical_key[0] = '\0';
+        return;
+    }
+    components->canonical_key[0] = '\0';
+    const char *parts[] = {
+        components->street_number,
+        components->street_direction,
+        components->street_name,
+        components->street_suffix,
+        components->city,
+        components->state,
+        components->postal_code};
 
     for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); ++i) {
         size_t current_len = strlen(components->canonical_key);
@@ -702,86 +1693,36 @@ static void add_breakdown_entry(
     entry->weight = weight;
 }
 
-static ScoreBreakdown score_components(
+static ComponentScores score_components(
     const AddressComponents *left,
     const AddressComponents *right,
+    double name_similarity,
+    double city_similarity,
     int require_zip) {
-    ScoreBreakdown breakdown;
-    memset(&breakdown, 0, sizeof(breakdown));
+    ComponentScores scores;
+    memset(&scores, 0, sizeof(scores));
 
     if (left == NULL || right == NULL) {
-        return breakdown;
+        return scores;
     }
 
-    double score = 0.0;
-
-    double number_match = 0.0;
     if (left->street_number[0] != '\0' && right->street_number[0] != '\0') {
-        number_match = (strcmp(left->street_number, right->street_number) == 0) ? 1.0 : 0.0;
+        scores.components[0] = (strcmp(left->street_number, right->street_number) == 0) ? 1.0 : 0.0;
     }
-    score += WEIGHTS[0] * number_match;
-    add_breakdown_entry(
-        &breakdown,
-        "street_number",
-        left->street_number,
-        right->street_number,
-        WEIGHTS[0]);
-
-    double name_similarity = similarity_ratio(left->street_name, right->street_name);
-    score += WEIGHTS[1] * name_similarity;
-    add_breakdown_entry(
-        &breakdown,
-        "street_name",
-        left->street_name,
-        right->street_name,
-        WEIGHTS[1]);
+    scores.components[1] = name_similarity;
 
     const char *left_dir = normalize_direction(left->street_direction);
     const char *right_dir = normalize_direction(right->street_direction);
-    double dir_match = 0.0;
     if (left_dir[0] != '\0' && right_dir[0] != '\0') {
-        dir_match = (strcmp(left_dir, right_dir) == 0) ? 1.0 : 0.0;
+        scores.components[2] = (strcmp(left_dir, right_dir) == 0) ? 1.0 : 0.0;
     }
-    score += WEIGHTS[2] * dir_match;
-    add_breakdown_entry(
-        &breakdown,
-        "directional",
-        left_dir,
-        right_dir,
-        WEIGHTS[2]);
-
-    double suffix_match = 0.0;
     if (left->street_suffix[0] != '\0' && right->street_suffix[0] != '\0') {
-        suffix_match = (strcmp(left->street_suffix, right->street_suffix) == 0) ? 1.0 : 0.0;
+        scores.components[3] = (strcmp(left->street_suffix, right->street_suffix) == 0) ? 1.0 : 0.0;
     }
-    score += WEIGHTS[3] * suffix_match;
-    add_breakdown_entry(
-        &breakdown,
-        "suffix",
-        left->street_suffix,
-        right->street_suffix,
-        WEIGHTS[3]);
-
-    double city_similarity = similarity_ratio(left->city, right->city);
-    score += WEIGHTS[4] * city_similarity;
-    add_breakdown_entry(
-        &breakdown,
-        "city",
-        left->city,
-        right->city,
-        WEIGHTS[4]);
-
-    double state_match = 0.0;
+    scores.components[4] = city_similarity;
     if (left->state[0] != '\0' && right->state[0] != '\0') {
-        state_match = (strcmp(left->state, right->state) == 0) ? 1.0 : 0.0;
+        scores.components[5] = (strcmp(left->state, right->state) == 0) ? 1.0 : 0.0;
     }
-    score += WEIGHTS[5] * state_match;
-    add_breakdown_entry(
-        &breakdown,
-        "state",
-        left->state,
-        right->state,
-        WEIGHTS[5]);
 
     char left_zip[AMS_MAX_POSTAL_LENGTH];
     char right_zip[AMS_MAX_POSTAL_LENGTH];
@@ -789,38 +1730,186 @@ static ScoreBreakdown score_components(
     copy_field(right_zip, sizeof(right_zip), right->postal_code);
     canonicalize_zip(left_zip);
     canonicalize_zip(right_zip);
-
-    double zip_match = 0.0;
     if (left_zip[0] != '\0' && right_zip[0] != '\0') {
-        zip_match = (strcmp(left_zip, right_zip) == 0) ? 1.0 : 0.0;
+        scores.components[6] = (strcmp(left_zip, right_zip) == 0) ? 1.0 : 0.0;
     }
     if (require_zip && left_zip[0] != '\0' && right_zip[0] == '\0') {
-        zip_match = 0.0;
+        scores.components[6] = 0.0;
+    }
+
+    double score = 0.0;
+    for (size_t i = 0; i < MATCHER_SCORE_COMPONENTS; ++i) {
+        score += WEIGHTS[i] * scores.components[i];
+    }
+    scores.score = score;
+    return scores;
+}
+
+int match_result_explain(const MatchResult *result, size_t index, ScoreBreakdown *breakdown) {
+    if (result == NULL || breakdown == NULL || index >= result->count) {
+        return -1;
     }
-    score += WEIGHTS[6] * zip_match;
+    memset(breakdown, 0, sizeof(*breakdown));
+
+    const AddressComponents *left = &result->record_components;
+    const AddressComponents *right = &result->items[index].location->components;
+    add_breakdown_entry(breakdown, "street_number", left->street_number, right->street_number, WEIGHTS[0]);
+    add_breakdown_entry(breakdown, "street_name", left->street_name, right->street_name, WEIGHTS[1]);
     add_breakdown_entry(
-        &breakdown,
-        "postal_code",
-        left_zip,
-        right_zip,
-        WEIGHTS[6]);
+        breakdown,
+        "directional",
+        normalize_direction(left->street_direction),
+        normalize_direction(right->street_direction),
+        WEIGHTS[2]);
+    add_breakdown_entry(breakdown, "suffix", left->street_suffix, right->street_suffix, WEIGHTS[3]);
+    add_breakdown_entry(breakdown, "city", left->city, right->city, WEIGHTS[4]);
+    add_breakdown_entry(breakdown, "state", left->state, right->state, WEIGHTS[5]);
+
+    char left_zip[AMS_MAX_POSTAL_LENGTH];
+    char right_zip[AMS_MAX_POSTAL_LENGTH];
+    copy_field(left_zip, sizeof(left_zip), left->postal_code);
+    copy_field(right_zip, sizeof(right_zip), right->postal_code);
+    canonicalize_zip(left_zip);
+    canonicalize_zip(right_zip);
+    add_breakdown_entry(breakdown, "postal_code", left_zip, right_zip, WEIGHTS[6]);
 
-    breakdown.score = score;
-    return breakdown;
+    breakdown->score = result->items[index].scores.score;
+    return 0;
+}
+
+static void similarity_memo_init(
+    SimilarityMemo *memo,
+    const StringDictionary *dictionary,
+    const char *query_value) {
+    memo->dictionary = dictionary;
+    memo->query_value = query_value;
+    memo->values = NULL;
+    memo->known = NULL;
+    if (dictionary == NULL || dictionary->count == 0) {
+        return;
+    }
+    memo->values = malloc(dictionary->count * sizeof(double));
+    memo->known = calloc(dictionary->count, sizeof(unsigned char));
+    if (memo->values == NULL || memo->known == NULL) {
+        similarity_memo_free(memo);
+    }
+}
+
+static void similarity_memo_free(SimilarityMemo *memo) {
+    free(memo->values);
+    free(memo->known);
+    memo->values = NULL;
+    memo->known = NULL;
+}
+
+static double similarity_memo_lookup(SimilarityMemo *memo, uint32_t id, const char *value, double min_similarity) {
+    if (memo->known == NULL || id >= memo->dictionary->count) {
+        return similarity_ratio_bounded(memo->query_value, value, min_similarity);
+    }
+    if (memo->known[id] == AMS_SIMILARITY_EXACT ||
+        (memo->known[id] == AMS_SIMILARITY_BOUNDED && memo->values[id] < min_similarity)) {
+        return memo->values[id];
+    }
+    double similarity = similarity_ratio_bounded(
+        memo->query_value,
+        string_dictionary_get(memo->dictionary, id),
+        min_similarity);
+    memo->values[id] = similarity;
+    memo->known[id] = similarity >= min_similarity ? AMS_SIMILARITY_EXACT : AMS_SIMILARITY_BOUNDED;
+    return similarity;
+}
+
+static void similarity_memo_prefetch(SimilarityMemo *memo, const uint32_t *ids, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    const char *names[AMS_BLOCK_CHUNK];
+    size_t lengths[AMS_BLOCK_CHUNK];
+    int distances[AMS_BLOCK_CHUNK];
+    size_t query_length = strlen(memo->query_value);
+    for (size_t i = 0; i < count; ++i) {
+        names[i] = string_dictionary_get(memo->dictionary, ids[i]);
+        lengths[i] = strlen(names[i]);
+    }
+    edit_distance_batch(memo->query_value, query_length, names, lengths, count, distances);
+    for (size_t i = 0; i < count; ++i) {
+        size_t max_len = query_length > lengths[i] ? query_length : lengths[i];
+        memo->values[ids[i]] = lengths[i] == 0 ? 0.0 : similarity_from_distance(distances[i], max_len);
+        memo->known[ids[i]] = AMS_SIMILARITY_EXACT;
+    }
+}
+
+static void scoring_context_init(
+    ScoringContext *context,
+    const AddressComponents *query,
+    const LocationStore *store) {
+    context->query = query;
+    context->deadline_ns = 0;
+    similarity_memo_init(&context->street_names, store ? &store->street_names : NULL, query->street_name);
+    similarity_memo_init(&context->cities, store ? &store->cities : NULL, query->city);
+}
+
+static void scoring_context_free(ScoringContext *context) {
+    similarity_memo_free(&context->street_names);
+    similarity_memo_free(&context->cities);
+}
+
+static double location_name_similarity(
+    ScoringContext *context,
+    const LocationRecord *location,
+    double min_similarity) {
+    return similarity_memo_lookup(
+        &context->street_names,
+        location->street_name_id,
+        location->components.street_name,
+        min_similarity);
+}
+
+static double location_city_similarity(
+    ScoringContext *context,
+    const LocationRecord *location,
+    double min_similarity) {
+    return similarity_memo_lookup(&context->cities, location->city_id, location->components.city, min_similarity);
+}
+
+static ComponentScores score_location(
+    ScoringContext *context,
+    const LocationRecord *location,
+    int require_zip) {
+    return score_components(
+        context->query,
+        &location->components,
+        location_name_similarity(context, location, 0.0),
+        location_city_similarity(context, location, 0.0),
+        require_zip);
 }
 
 static double similarity_ratio(const char *left, const char *right) {
+    return similarity_ratio_bounded(left, right, 0.0);
+}
+
+static double similarity_ratio_bounded(const char *left, const char *right, double min_similarity) {
     if (left == NULL || right == NULL || left[0] == '\0' || right[0] == '\0') {
         return 0.0;
     }
     if (strcmp(left, right) == 0) {
         return 1.0;
     }
-    int distance = levenshtein_distance(left, right);
-    size_t max_len = strlen(left) > strlen(right) ? strlen(left) : strlen(right);
+    size_t left_length = strlen(left);
+    size_t right_length = strlen(right);
+    size_t max_len = left_length > right_length ? left_length : right_length;
     if (max_len == 0) {
         return 0.0;
     }
+    int max_distance = (int)max_len;
+    if (min_similarity > 0.0) {
+        max_distance = (int)((1.0 - (min_similarity < 1.0 ? min_similarity : 1.0)) * (double)max_len + 1e-9);
+    }
+    int distance = edit_distance_bounded(left, left_length, right, right_length, max_distance);
+    return similarity_from_distance(distance, max_len);
+}
+
+static double similarity_from_distance(int distance, size_t max_len) {
     double ratio = 1.0 - ((double)distance / (double)max_len);
     if (ratio < 0.0) {
         ratio = 0.0;
@@ -830,60 +1919,72 @@ static double similarity_ratio(const char *left, const char *right) {
     return ratio;
 }
 
-static int levenshtein_distance(const char *left, const char *right) {
-    size_t len_left = strlen(left);
-    size_t len_right = strlen(right);
-    if (len_left == 0) {
-        return (int)len_right;
-    }
-    if (len_right == 0) {
-        return (int)len_left;
+static const ParserKeyword *lookup_keyword(const char *text, size_t length) {
+    if (rules_loaded) {
+        return normalization_rules_lookup(&loaded_rules, text, length);
     }
+    return parser_keyword_find(text, length);
+}
 
-    int *prev = (int *)malloc((len_right + 1) * sizeof(int));
-    int *curr = (int *)malloc((len_right + 1) * sizeof(int));
-    if (prev == NULL || curr == NULL) {
-        free(prev);
-        free(curr);
-        return (int)(len_left > len_right ? len_left : len_right);
+static size_t tokenize_address(const char *text, TokenSpan *tokens, size_t max_tokens) {
+    size_t count = 0;
+    const char *cursor = text;
+    while (*cursor != '\0' && count < max_tokens) {
+        while (*cursor == ' ' || *cursor == ',') {
+            ++cursor;
+        }
+        const char *start = cursor;
+        while (*cursor != '\0' && *cursor != ' ' && *cursor != ',') {
+            ++cursor;
+        }
+        const char *end = cursor;
+        while (start < end && isspace((unsigned char)*start)) {
+            ++start;
+        }
+        while (end > start && isspace((unsigned char)end[-1])) {
+            --end;
+        }
+        if (start == end) {
+            continue;
+        }
+        size_t length = (size_t)(end - start);
+        if (length >= AMS_MAX_FIELD_LENGTH) {
+            length = AMS_MAX_FIELD_LENGTH - 1;
+        }
+        const ParserKeyword *keyword = lookup_keyword(start, length);
+        tokens[count].start = start;
+        tokens[count].length = length;
+        tokens[count].kinds = keyword != NULL ? keyword->kinds : 0;
+        ++count;
     }
+    return count;
+}
 
-    for (size_t j = 0; j <= len_right; ++j) {
-        prev[j] = (int)j;
+static void copy_span(char *dest, size_t dest_size, const TokenSpan *token) {
+    if (dest == NULL || dest_size == 0) {
+        return;
     }
+    size_t length = token->length < dest_size ? token->length : dest_size - 1;
+    memcpy(dest, token->start, length);
+    dest[length] = '\0';
+}
 
-    for (size_t i = 1; i <= len_left; ++i) {
-        curr[0] = (int)i;
-        for (size_t j = 1; j <= len_right; ++j) {
-            int cost = (left[i - 1] == right[j - 1]) ? 0 : 1;
-            int deletion = prev[j] + 1;
-            int insertion = curr[j - 1] + 1;
-            int substitution = prev[j - 1] + cost;
-            int minimum = deletion < insertion ? deletion : insertion;
-            if (substitution < minimum) {
-                minimum = substitution;
-            }
-            curr[j] = minimum;
-        }
-        int *tmp = prev;
-        prev = curr;
-        curr = tmp;
+static void append_span(char *dest, size_t dest_size, const char *text, size_t length) {
+    size_t used = strlen(dest);
+    if (used + 1 >= dest_size) {
+        return;
     }
-
-    int distance = prev[len_right];
-    free(prev);
-    free(curr);
-    return distance;
+    if (length > dest_size - used - 1) {
+        length = dest_size - used - 1;
+    }
+    memcpy(dest + used, text, length);
+    dest[used + length] = '\0';
 }
 
-static int is_zip_code(const char *token) {
-    if (token == NULL || token[0] == '\0') {
-        return 0;
-    }
-    size_t length = strlen(token);
+static int is_zip_code(const TokenSpan *token) {
     size_t digits = 0;
-    for (size_t i = 0; i < length; ++i) {
-        char c = token[i];
+    for (size_t i = 0; i < token->length; ++i) {
+        char c = token->start[i];
         if (isdigit((unsigned char)c)) {
             ++digits;
             continue;
@@ -918,74 +2019,46 @@ static const char *normalize_direction(const char *token) {
     if (token == NULL) {
         return "";
     }
-    for (size_t i = 0; i < sizeof(DIRECTIONAL_MAP) / sizeof(DIRECTIONAL_MAP[0]); ++i) {
-        if (strcmp(token, DIRECTIONAL_MAP[i].token) == 0) {
-            return DIRECTIONAL_MAP[i].canonical;
-        }
+    const ParserKeyword *keyword = lookup_keyword(token, strlen(token));
+    if (keyword != NULL && (keyword->kinds & AMS_KEYWORD_DIRECTION)) {
+        return keyword->canonical;
     }
     return token;
 }
 
-static const char *normalize_state(const char *token) {
-    if (token == NULL) {
-        return "";
-    }
-    char upper[AMS_MAX_STATE_LENGTH];
-    copy_field(upper, sizeof(upper), token);
-    uppercase_inplace(upper);
-    if (strlen(upper) == 2) {
-        for (size_t i = 0; i < sizeof(STATE_CODES) / sizeof(STATE_CODES[0]); ++i) {
-            if (strcmp(upper, STATE_CODES[i]) == 0) {
-                return STATE_CODES[i];
-            }
-        }
-    }
-    static char fallback[AMS_MAX_STATE_LENGTH];
-    copy_field(fallback, sizeof(fallback), upper);
-    if (strlen(fallback) > 2) {
-        fallback[2] = '\0';
-    }
-    return fallback;
-}
-
-static int is_primary_suffix(const char *token) {
-    if (token == NULL) {
-        return 0;
-    }
-    for (size_t i = 0; i < sizeof(PRIMARY_SUFFIXES) / sizeof(PRIMARY_SUFFIXES[0]); ++i) {
-        if (strcmp(token, PRIMARY_SUFFIXES[i]) == 0) {
-            return 1;
-        }
-    }
-    return 0;
-}
-
-static int is_unit_token(const char *token) {
-    if (token == NULL) {
-        return 0;
+static int normalize_state(const TokenSpan *token, char *state, size_t state_size) {
+    if (token->kinds & AMS_KEYWORD_STATE) {
+        copy_span(state, state_size, token);
+        return 1;
     }
-    for (size_t i = 0; i < sizeof(UNIT_TOKENS) / sizeof(UNIT_TOKENS[0]); ++i) {
-        if (strcmp(token, UNIT_TOKENS[i]) == 0) {
-            return 1;
-        }
+    TokenSpan prefix = *token;
+    if (prefix.length > 2) {
+        prefix.length = 2;
     }
-    return 0;
+    copy_span(state, state_size, &prefix);
+    return prefix.length > 0;
 }
-
-static int is_unit_followup(const char *token) {
-    if (token == NULL) {
-        return 0;
-    }
-    if (token[0] == '#') {
+
+static int is_unit_followup(const TokenSpan *token) {
+    if (token->start[0] == '#') {
         return 1;
     }
-    if (isdigit((unsigned char)token[0])) {
+    if (isdigit((unsigned char)token->start[0])) {
         return 1;
     }
-    if (strlen(token) <= 3) {
-        return 1;
+    return token->length <= 3;
+}
+
+static void build_address_rewriter(void) {
+    size_t expansion_count = sizeof(EXPANSIONS) / sizeof(EXPANSIONS[0]);
+    size_t numbered_count = sizeof(NUMBERED_STREETS) / sizeof(NUMBERED_STREETS[0]);
+    RewriteRule rules[sizeof(EXPANSIONS) / sizeof(EXPANSIONS[0]) +
+                      sizeof(NUMBERED_STREETS) / sizeof(NUMBERED_STREETS[0])];
+    memcpy(rules, EXPANSIONS, sizeof(EXPANSIONS));
+    memcpy(rules + expansion_count, NUMBERED_STREETS, sizeof(NUMBERED_STREETS));
+    if (text_rewriter_build(&address_rewriter, rules, expansion_count + numbered_count) != 0) {
+        fprintf(stderr, "Failed to compile address rewrite rules\n");
     }
-    return 0;
 }
 
 static void expand_address_text(const char *source, char *dest, size_t dest_size) {
@@ -1001,78 +2074,32 @@ static void expand_address_text(const char *source, char *dest, size_t dest_size
     snprintf(buffer, sizeof(buffer), " %s ", source);
     uppercase_inplace(buffer);
 
-    for (size_t i = 0; i < sizeof(EXPANSIONS) / sizeof(EXPANSIONS[0]); ++i) {
-        const char *needle = EXPANSIONS[i].needle;
-        const char *replacement = EXPANSIONS[i].replacement;
-        char *pos = strstr(buffer, needle);
-        while (pos) {
-            size_t needle_len = strlen(needle);
-            size_t replacement_len = strlen(replacement);
-            size_t tail_len = strlen(pos + needle_len);
-            if (replacement_len > needle_len &&
-                strlen(buffer) + (replacement_len - needle_len) >= sizeof(buffer) - 1) {
-                break;
-            }
-            memmove(pos + replacement_len, pos + needle_len, tail_len + 1);
-            memcpy(pos, replacement, replacement_len);
-            pos = strstr(pos + replacement_len, needle);
-        }
-    }
-
-    for (size_t i = 0; i < sizeof(NUMBERED_STREETS) / sizeof(NUMBERED_STREETS[0]); ++i) {
-        const char *needle = NUMBERED_STREETS[i].needle;
-        const char *replacement = NUMBERED_STREETS[i].replacement;
-        char *pos = strstr(buffer, needle);
-        while (pos) {
-            size_t needle_len = strlen(needle);
-            size_t replacement_len = strlen(replacement);
-            size_t tail_len = strlen(pos + needle_len);
-            if (replacement_len > needle_len &&
-                strlen(buffer) + (replacement_len - needle_len) >= sizeof(buffer) - 1) {
-                break;
-            }
-            memmove(pos + replacement_len, pos + needle_len, tail_len + 1);
-            memcpy(pos, replacement, replacement_len);
-            pos = strstr(pos + replacement_len, needle);
-        }
-    }
-
-    copy_field(dest, dest_size, buffer);
+    pthread_once(&address_rewriter_once, build_address_rewriter);
+    text_rewriter_apply(&address_rewriter, buffer, strlen(buffer), dest, dest_size);
 }
 
-static void normalize_ordinal_token(char *token) {
-    if (token == NULL) {
-        return;
-    }
-    size_t length = strlen(token);
+static size_t ordinal_token_length(const TokenSpan *token) {
+    size_t length = token->length;
     if (length < 3) {
-        return;
+        return length;
     }
-    if (length > 2) {
-        size_t offset = length - 2;
-        if (isdigit((unsigned char)token[0]) && isdigit((unsigned char)token[offset - 1])) {
-            if ((token[offset] == 'S' && token[offset + 1] == 'T') ||
-                (token[offset] == 'N' && token[offset + 1] == 'D') ||
-                (token[offset] == 'R' && token[offset + 1] == 'D') ||
-                (token[offset] == 'T' && token[offset + 1] == 'H')) {
-                token[offset] = '\0';
-                return;
-            }
+    const char *tail = token->start + length - 2;
+    if (isdigit((unsigned char)token->start[0]) && isdigit((unsigned char)tail[-1])) {
+        if ((tail[0] == 'S' && tail[1] == 'T') || (tail[0] == 'N' && tail[1] == 'D') ||
+            (tail[0] == 'R' && tail[1] == 'D') || (tail[0] == 'T' && tail[1] == 'H')) {
+            return length - 2;
         }
     }
+    return length;
 }
 
-static int extract_house_number(char *token, char *number_out, size_t number_size) {
-    if (token == NULL || number_out == NULL) {
-        return 0;
-    }
-    size_t length = strlen(token);
-    if (length == 0) {
+static int extract_house_number(TokenSpan *token, char *number_out, size_t number_size) {
+    if (number_out == NULL || token->length == 0) {
         return 0;
     }
 
     size_t idx = 0;
-    while (idx < length && (isdigit((unsigned char)token[idx]) || token[idx] == '-')) {
+    while (idx < token->length && (isdigit((unsigned char)token->start[idx]) || token->start[idx] == '-')) {
         ++idx;
     }
     if (idx == 0) {
@@ -1080,18 +2107,13 @@ static int extract_house_number(char *token, char *number_out, size_t number_siz
     }
 
     size_t copy_length = idx < number_size ? idx : number_size - 1;
-    memcpy(number_out, token, copy_length);
+    memcpy(number_out, token->start, copy_length);
     number_out[copy_length] = '\0';
 
-    while (idx < length && token[idx] == '-') {
-        ++idx;
-    }
-
-    if (idx < length) {
-        memmove(token, token + idx, length - idx + 1);
-    } else {
-        token[0] = '\0';
-    }
+    token->start += idx;
+    token->length -= idx;
+    const ParserKeyword *keyword = lookup_keyword(token->start, token->length);
+    token->kinds = keyword != NULL ? keyword->kinds : 0;
     return 1;
 }
 
@@ -1117,147 +2139,196 @@ static void add_candidate(
     double confidence,
     const char *strategy,
     const char *reason,
-    const ScoreBreakdown *breakdown,
+    const ComponentScores *scores,
     size_t max_candidates) {
     if (result == NULL || location == NULL || strategy == NULL) {
         return;
     }
 
-    size_t existing_index = SIZE_MAX;
-    for (size_t i = 0; i < result->count; ++i) {
-        if (strcmp(result->items[i].location->location_id, location->location_id) == 0) {
-            existing_index = i;
-            break;
+    uint64_t key = location->id_fingerprint;
+    for (size_t slot = 0; slot < result->count; ++slot) {
+        if (result->candidate_keys[slot] != key ||
+            strcmp(result->items[slot].location->location_id, location->location_id) != 0) {
+            continue;
+        }
+        if (confidence > result->items[slot].confidence) {
+            fill_candidate(&result->items[slot], location, confidence, strategy, reason, scores);
+            candidate_heap_sift_down(result, result->heap_positions[slot]);
         }
+        return;
     }
 
-    if (existing_index != SIZE_MAX) {
-        if (confidence > result->items[existing_index].confidence) {
-            result->items[existing_index].confidence = confidence;
-            copy_field(result->items[existing_index].strategy, sizeof(result->items[existing_index].strategy), strategy);
-            if (reason) {
-                copy_field(result->items[existing_index].reason, sizeof(result->items[existing_index].reason), reason);
-            }
-            if (breakdown) {
-                result->items[existing_index].breakdown = *breakdown;
-            }
-        }
+    size_t limit = max_candidates < MATCHER_MAX_CANDIDATES ? max_candidates : MATCHER_MAX_CANDIDATES;
+    if (result->count < limit) {
+        size_t slot = result->count++;
+        fill_candidate(&result->items[slot], location, confidence, strategy, reason, scores);
+        result->candidate_keys[slot] = key;
+        result->heap[slot] = (uint8_t)slot;
+        result->heap_positions[slot] = (uint8_t)slot;
+        candidate_heap_sift_up(result, slot);
+        return;
+    }
+    if (result->count == 0) {
         return;
     }
 
-    if (result->count < max_candidates && result->count < MATCHER_MAX_CANDIDATES) {
-        MatchCandidate *candidate = &result->items[result->count++];
-        candidate->location = location;
-        candidate->confidence = confidence;
-        copy_field(candidate->strategy, sizeof(candidate->strategy), strategy);
-        if (reason) {
-            copy_field(candidate->reason, sizeof(candidate->reason), reason);
-        } else {
-            candidate->reason[0] = '\0';
-        }
-        if (breakdown) {
-            candidate->breakdown = *breakdown;
-        } else {
-            memset(&candidate->breakdown, 0, sizeof(candidate->breakdown));
-        }
+    size_t slot = result->heap[0];
+    const MatchCandidate *weakest = &result->items[slot];
+    if (confidence < weakest->confidence ||
+        (confidence == weakest->confidence &&
+         strcmp(location->location_id, weakest->location->location_id) >= 0)) {
         return;
     }
+    fill_candidate(&result->items[slot], location, confidence, strategy, reason, scores);
+    result->candidate_keys[slot] = key;
+    candidate_heap_sift_down(result, 0);
+}
 
-    size_t lowest_index = SIZE_MAX;
-    double lowest_confidence = 1.1;
-    for (size_t i = 0; i < result->count; ++i) {
-        if (result->items[i].confidence < lowest_confidence) {
-            lowest_confidence = result->items[i].confidence;
-            lowest_index = i;
-        }
-    }
-    if (lowest_index != SIZE_MAX && confidence > lowest_confidence) {
-        MatchCandidate *candidate = &result->items[lowest_index];
-        candidate->location = location;
-        candidate->confidence = confidence;
-        copy_field(candidate->strategy, sizeof(candidate->strategy), strategy);
-        if (reason) {
-            copy_field(candidate->reason, sizeof(candidate->reason), reason);
-        } else {
-            candidate->reason[0] = '\0';
+static void fill_candidate(
+    MatchCandidate *candidate,
+    const LocationRecord *location,
+    double confidence,
+    const char *strategy,
+    const char *reason,
+    const ComponentScores *scores) {
+    candidate->location = location;
+    candidate->confidence = confidence;
+    candidate->strategy = strategy;
+    candidate->reason = reason != NULL ? reason : "";
+    if (scores) {
+        candidate->scores = *scores;
+    } else {
+        memset(&candidate->scores, 0, sizeof(candidate->scores));
+    }
+}
+
+static int candidate_weaker(const MatchResult *result, size_t left_slot, size_t right_slot) {
+    const MatchCandidate *left = &result->items[left_slot];
+    const MatchCandidate *right = &result->items[right_slot];
+    if (left->confidence != right->confidence) {
+        return left->confidence < right->confidence;
+    }
+    return strcmp(left->location->location_id, right->location->location_id) > 0;
+}
+
+static void candidate_heap_swap(MatchResult *result, size_t left, size_t right) {
+    uint8_t slot = result->heap[left];
+    result->heap[left] = result->heap[right];
+    result->heap[right] = slot;
+    result->heap_positions[result->heap[left]] = (uint8_t)left;
+    result->heap_positions[result->heap[right]] = (uint8_t)right;
+}
+
+static void candidate_heap_sift_up(MatchResult *result, size_t position) {
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+        if (!candidate_weaker(result, result->heap[position], result->heap[parent])) {
+            break;
         }
-        if (breakdown) {
-            candidate->breakdown = *breakdown;
-        } else {
-            memset(&candidate->breakdown, 0, sizeof(candidate->breakdown));
+        candidate_heap_swap(result, position, parent);
+        position = parent;
+    }
+}
+
+static void candidate_heap_sift_down(MatchResult *result, size_t position) {
+    for (;;) {
+        size_t weakest = position;
+        size_t left = 2 * position + 1;
+        size_t right = left + 1;
+        if (left < result->count && candidate_weaker(result, result->heap[left], result->heap[weakest])) {
+            weakest = left;
+        }
+        if (right < result->count && candidate_weaker(result, result->heap[right], result->heap[weakest])) {
+            weakest = right;
         }
+        if (weakest == position) {
+            return;
+        }
+        candidate_heap_swap(result, position, weakest);
+        position = weakest;
     }
 }
 
 static void strategy_canonical(
-    const AddressComponents *query,
+    ScoringContext *context,
     const LocationStore *store,
     const MatcherConfig *config,
     MatchResult *result) {
+    const AddressComponents *query = context->query;
     if (query == NULL || store == NULL || result == NULL || query->canonical_key[0] == '\0') {
         return;
     }
 
-    for (size_t i = 0; i < store->count; ++i) {
-        const LocationRecord *location = &store->items[i];
-        if (location->components.canonical_key[0] == '\0') {
-            continue;
-        }
+    size_t match_count = 0;
+    const uint32_t *matches = key_index_lookup(
+        &store->canonical_index,
+        ams_fingerprint(query->canonical_key),
+        &match_count);
+    for (size_t i = 0; i < match_count; ++i) {
+        const LocationRecord *location = &store->items[matches[i]];
         if (strcmp(query->canonical_key, location->components.canonical_key) != 0) {
             continue;
         }
-        ScoreBreakdown breakdown = score_components(query, &location->components, 1);
-        double confidence = breakdown.score >= 0.9 ? 1.0 : breakdown.score;
+        ComponentScores scores = score_location(context, location, 1);
+        double confidence = scores.score >= 0.9 ? 1.0 : scores.score;
         add_candidate(
             result,
             location,
             confidence,
             "canonical",
             "canonical_key_match",
-            &breakdown,
+            &scores,
             config->max_candidates);
     }
 }
 
-static void strategy_structured(
-    const AddressComponents *query,
-    const LocationStore *store,
-    const MatcherConfig *config,
-    MatchResult *result) {
-    if (query == NULL || store == NULL || result == NULL || config == NULL) {
-        return;
-    }
-    for (size_t i = 0; i < store->count; ++i) {
-        const LocationRecord *location = &store->items[i];
-        ScoreBreakdown breakdown = score_components(query, &location->components, 0);
-        if (breakdown.score >= config->structured_min_confidence) {
-            add_candidate(
-                result,
-                location,
-                breakdown.score,
-                "structured",
-                "weighted_component_score",
-                &breakdown,
-                config->max_candidates);
-        }
-    }
-}
-
-static void strategy_fuzzy(
-    const AddressComponents *query,
+static void strategy_block(
+    ScoringContext *context,
     const LocationStore *store,
+    const CandidateBlock *block,
     const MatcherConfig *config,
     MatchResult *result) {
-    if (query == NULL || store == NULL || result == NULL || config == NULL) {
+    const AddressComponents *query = context->query;
+    if (query == NULL || store == NULL || block == NULL || result == NULL || config == NULL) {
         return;
     }
 
-    for (size_t i = 0; i < store->count; ++i) {
-        const LocationRecord *location = &store->items[i];
-        ScoreBreakdown structured = score_components(query, &location->components, 0);
+    double exact_scores[AMS_BLOCK_CHUNK];
+    for (size_t i = 0; i < block->count; ++i) {
+        const LocationRecord *location = &store->items[block->indices ? block->indices[i] : block->base + i];
+        double floor = candidate_admission_floor(result, config);
+        if (i % AMS_BLOCK_CHUNK == 0) {
+            if (budget_remaining_ms(context) == 0) {
+                result->degraded = 1;
+                break;
+            }
+            prefetch_block_chunk(context, store, block, i, config, floor, exact_scores);
+        }
+        double exact_score = exact_scores[i % AMS_BLOCK_CHUNK];
+        if (!block_record_admissible(exact_score, 1.0, 1.0, config, floor)) {
+            continue;
+        }
+        double name_similarity = location_name_similarity(
+            context,
+            location,
+            required_similarity(exact_score, -1.0, config, floor));
+        if (!block_record_admissible(exact_score, name_similarity, 1.0, config, floor)) {
+            continue;
+        }
+        double city_similarity = location_city_similarity(
+            context,
+            location,
+            required_similarity(exact_score, name_similarity, config, floor));
+        if (!block_record_admissible(exact_score, name_similarity, city_similarity, config, floor)) {
+            continue;
+        }
+        ComponentScores structured = score_components(
+            query,
+            &location->components,
+            name_similarity,
+            city_similarity,
+            0);
 
-        double name_similarity = similarity_ratio(query->street_name, location->components.street_name);
-        double city_similarity = similarity_ratio(query->city, location->components.city);
         double postal_similarity = 0.0;
         if (query->postal_code[0] != '\0' && location->components.postal_code[0] != '\0') {
             postal_similarity = similarity_ratio(query->postal_code, location->components.postal_code);
@@ -1271,7 +2342,9 @@ static void strategy_fuzzy(
             fuzzy_score = 1.0;
         }
 
-        if (fuzzy_score >= config->fuzzy_min_confidence) {
+        int structured_passes = structured.score >= config->structured_min_confidence;
+        int fuzzy_passes = fuzzy_score >= config->fuzzy_min_confidence;
+        if (fuzzy_passes && (!structured_passes || fuzzy_score > structured.score)) {
             add_candidate(
                 result,
                 location,
@@ -1280,12 +2353,265 @@ static void strategy_fuzzy(
                 "approximate_text_similarity",
                 &structured,
                 config->max_candidates);
+        } else if (structured_passes) {
+            add_candidate(
+                result,
+                location,
+                structured.score,
+                "structured",
+                "weighted_component_score",
+                &structured,
+                config->max_candidates);
+        }
+    }
+}
+
+static double exact_component_score(const AddressComponents *left, const AddressComponents *right) {
+    double score = 0.0;
+    if (left->street_number[0] != '\0' && strcmp(left->street_number, right->street_number) == 0) {
+        score += WEIGHTS[0];
+    }
+    const char *left_dir = normalize_direction(left->street_direction);
+    if (left_dir[0] != '\0' && strcmp(left_dir, normalize_direction(right->street_direction)) == 0) {
+        score += WEIGHTS[2];
+    }
+    if (left->street_suffix[0] != '\0' && strcmp(left->street_suffix, right->street_suffix) == 0) {
+        score += WEIGHTS[3];
+    }
+    if (left->state[0] != '\0' && strcmp(left->state, right->state) == 0) {
+        score += WEIGHTS[5];
+    }
+    if (left->postal_code[0] != '\0' && right->postal_code[0] != '\0') {
+        char left_zip[AMS_MAX_POSTAL_LENGTH];
+        char right_zip[AMS_MAX_POSTAL_LENGTH];
+        copy_field(left_zip, sizeof(left_zip), left->postal_code);
+        copy_field(right_zip, sizeof(right_zip), right->postal_code);
+        canonicalize_zip(left_zip);
+        canonicalize_zip(right_zip);
+        if (left_zip[0] != '\0' && strcmp(left_zip, right_zip) == 0) {
+            score += WEIGHTS[6];
+        }
+    }
+    return score;
+}
+
+static double candidate_admission_floor(const MatchResult *result, const MatcherConfig *config) {
+    if (result->count < config->max_candidates && result->count < MATCHER_MAX_CANDIDATES) {
+        return -1.0;
+    }
+    return result->items[result->heap[0]].confidence;
+}
+
+static int block_record_admissible(
+    double exact_score,
+    double name_bound,
+    double city_bound,
+    const MatcherConfig *config,
+    double floor) {
+    double structured_bound = exact_score + WEIGHTS[1] * name_bound + WEIGHTS[4] * city_bound;
+    double fuzzy_bound = 0.6 * structured_bound + 0.25 * name_bound + 0.15 * city_bound + 0.05;
+    if (fuzzy_bound > 1.0) {
+        fuzzy_bound = 1.0;
+    }
+    structured_bound += AMS_SCORE_BOUND_SLACK;
+    fuzzy_bound += AMS_SCORE_BOUND_SLACK;
+
+    int structured_open = structured_bound >= config->structured_min_confidence && structured_bound > floor;
+    int fuzzy_open = fuzzy_bound >= config->fuzzy_min_confidence && fuzzy_bound > floor;
+    return structured_open || fuzzy_open;
+}
+
+static double required_similarity(
+    double exact_score,
+    double name_similarity,
+    const MatcherConfig *config,
+    double floor) {
+    double structured_target = config->structured_min_confidence > floor ? config->structured_min_confidence : floor;
+    double fuzzy_target = config->fuzzy_min_confidence > floor ? config->fuzzy_min_confidence : floor;
+    double structured_base;
+    double structured_weight;
+    double fuzzy_base;
+    double fuzzy_weight;
+    if (name_similarity < 0.0) {
+        structured_base = exact_score + WEIGHTS[4];
+        structured_weight = WEIGHTS[1];
+        fuzzy_base = 0.6 * structured_base + 0.15 + 0.05;
+        fuzzy_weight = 0.6 * WEIGHTS[1] + 0.25;
+    } else {
+        structured_base = exact_score + WEIGHTS[1] * name_similarity;
+        structured_weight = WEIGHTS[4];
+        fuzzy_base = 0.6 * structured_base + 0.25 * name_similarity + 0.05;
+        fuzzy_weight = 0.6 * WEIGHTS[4] + 0.15;
+    }
+
+    double structured_required = (structured_target - structured_base) / structured_weight;
+    double fuzzy_required = (fuzzy_target - fuzzy_base) / fuzzy_weight;
+    double required = structured_required < fuzzy_required ? structured_required : fuzzy_required;
+    required -= AMS_SIMILARITY_REQUIRED_MARGIN;
+    if (required < 0.0) {
+        return 0.0;
+    }
+    return required > 1.0 ? 1.0 : required;
+}
+
+static void prefetch_block_chunk(
+    ScoringContext *context,
+    const LocationStore *store,
+    const CandidateBlock *block,
+    size_t start,
+    const MatcherConfig *config,
+    double floor,
+    double *exact_scores) {
+    SimilarityMemo *memo = &context->street_names;
+    size_t end = block->count - start < AMS_BLOCK_CHUNK ? block->count : start + AMS_BLOCK_CHUNK;
+    uint32_t pending[AMS_BLOCK_CHUNK];
+    size_t pending_count = 0;
+    for (size_t i = start; i < end; ++i) {
+        const LocationRecord *location = &store->items[block->indices ? block->indices[i] : block->base + i];
+        double exact_score = exact_component_score(context->query, &location->components);
+        exact_scores[i - start] = exact_score;
+        uint32_t id = location->street_name_id;
+        if (memo->known == NULL || memo->query_value[0] == '\0' || id >= memo->dictionary->count ||
+            memo->known[id] == AMS_SIMILARITY_EXACT || memo->known[id] == AMS_SIMILARITY_PENDING ||
+            !block_record_admissible(exact_score, 1.0, 1.0, config, floor)) {
+            continue;
+        }
+        memo->known[id] = AMS_SIMILARITY_PENDING;
+        pending[pending_count++] = id;
+    }
+    if (pending_count < AMS_SIMILARITY_BATCH_MIN) {
+        for (size_t i = 0; i < pending_count; ++i) {
+            memo->known[pending[i]] = AMS_SIMILARITY_UNKNOWN;
+        }
+        return;
+    }
+    similarity_memo_prefetch(memo, pending, pending_count);
+}
+
+static void strategy_block_partitioned(
+    ScoringContext *context,
+    const LocationStore *store,
+    const CandidateBlock *block,
+    const MatcherConfig *config,
+    MatchResult *result) {
+    size_t partition_count = config->scan_threads;
+    if (partition_count < 2 || block->count < config->parallel_scan_min_block || block->count < partition_count) {
+        strategy_block(context, store, block, config, result);
+        return;
+    }
+
+    ScanPartition *partitions = calloc(partition_count, sizeof(ScanPartition));
+    MatchResult *locals = malloc(partition_count * sizeof(MatchResult));
+    ScoringContext *contexts = malloc(partition_count * sizeof(ScoringContext));
+    pthread_t *threads = malloc(partition_count * sizeof(pthread_t));
+    int *started = calloc(partition_count, sizeof(int));
+    MatchCandidate *merged = malloc(partition_count * MATCHER_MAX_CANDIDATES * sizeof(MatchCandidate));
+    if (partitions == NULL || locals == NULL || contexts == NULL || threads == NULL || started == NULL ||
+        merged == NULL) {
+        free(partitions);
+        free(locals);
+        free(contexts);
+        free(threads);
+        free(started);
+        free(merged);
+        strategy_block(context, store, block, config, result);
+        return;
+    }
+
+    size_t chunk = block->count / partition_count;
+    for (size_t p = 0; p < partition_count; ++p) {
+        ScanPartition *partition = &partitions[p];
+        size_t start = p * chunk;
+        size_t count = p + 1 == partition_count ? block->count - start : chunk;
+        partition->store = store;
+        partition->config = config;
+        partition->context = p == 0 ? context : &contexts[p];
+        partition->block.indices = block->indices ? block->indices + start : NULL;
+        partition->block.base = block->indices ? 0 : block->base + start;
+        partition->block.count = count;
+        locals[p] = *result;
+        partition->result = &locals[p];
+    }
+
+    for (size_t p = 1; p < partition_count; ++p) {
+        scoring_context_init(&contexts[p], context->query, store);
+        contexts[p].deadline_ns = context->deadline_ns;
+        started[p] = pthread_create(&threads[p], NULL, scan_partition, &partitions[p]) == 0;
+    }
+    scan_partition(&partitions[0]);
+    for (size_t p = 1; p < partition_count; ++p) {
+        if (started[p]) {
+            pthread_join(threads[p], NULL);
+        } else {
+            scan_partition(&partitions[p]);
+        }
+        scoring_context_free(&contexts[p]);
+    }
+
+    size_t merged_count = 0;
+    for (size_t p = 0; p < partition_count; ++p) {
+        result->degraded |= locals[p].degraded;
+        memcpy(merged + merged_count, locals[p].items, locals[p].count * sizeof(MatchCandidate));
+        merged_count += locals[p].count;
+    }
+    qsort(merged, merged_count, sizeof(MatchCandidate), compare_candidates);
+    for (size_t i = 0; i < merged_count; ++i) {
+        add_candidate(
+            result,
+            merged[i].location,
+            merged[i].confidence,
+            merged[i].strategy,
+            merged[i].reason,
+            &merged[i].scores,
+            config->max_candidates);
+    }
+
+    free(merged);
+    free(partitions);
+    free(locals);
+    free(contexts);
+    free(threads);
+    free(started);
+}
+
+static void *scan_partition(void *arg) {
+    ScanPartition *partition = (ScanPartition *)arg;
+    strategy_block(partition->context, partition->store, &partition->block, partition->config, partition->result);
+    return NULL;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static long budget_remaining_ms(const ScoringContext *context) {
+    if (context->deadline_ns == 0) {
+        return -1;
+    }
+    uint64_t now = monotonic_ns();
+    if (now >= context->deadline_ns) {
+        return 0;
+    }
+    return (long)((context->deadline_ns - now + 999999ULL) / 1000000ULL);
+}
+
+static int canonical_result_settled(const MatchResult *result, const MatcherConfig *config) {
+    if (result->count == 0 || result->count < config->max_candidates) {
+        return 0;
+    }
+    for (size_t i = 0; i < result->count; ++i) {
+        if (result->items[i].confidence < 1.0) {
+            return 0;
         }
     }
+    return 1;
 }
 
 static void strategy_llm(
     const char *raw_address,
+    ScoringContext *context,
     const LocationStore *store,
     const MatcherConfig *config,
     MatchResult *result) {
@@ -1295,6 +2621,13 @@ static void strategy_llm(
     if (result->count == 0 || raw_address == NULL) {
         return;
     }
+    if (!llm_result_ambiguous(result, config)) {
+        atomic_fetch_add_explicit(&llm_skipped_count, 1, memory_order_relaxed);
+        return;
+    }
+
+    char escaped_address[AMS_MAX_LINE_LENGTH * 2];
+    json_escape(escaped_address, sizeof(escaped_address), result->raw_address);
 
     char payload[AMS_LLM_PAYLOAD_LIMIT];
     size_t offset = 0;
@@ -1302,71 +2635,64 @@ static void strategy_llm(
         payload + offset,
         sizeof(payload) - offset,
         "{ \"address\": \"%s\", \"candidates\": [",
-        result->raw_address);
+        escaped_address);
+    uint64_t cache_key = llm_query_key(&result->record_components);
     size_t limit = result->count < AMS_LLM_MAX_INPUT_CANDIDATES ? result->count : AMS_LLM_MAX_INPUT_CANDIDATES;
-    for (size_t i = 0; i < limit && offset < sizeof(payload) - 1; ++i) {
+    for (size_t i = 0; i < limit; ++i) {
         const MatchCandidate *candidate = &result->items[i];
-        offset += snprintf(
-            payload + offset,
-            sizeof(payload) - offset,
+        char escaped_id[AMS_MAX_ID_LENGTH * 2];
+        char escaped_street[AMS_MAX_FIELD_LENGTH * 2];
+        char escaped_city[AMS_MAX_FIELD_LENGTH * 2];
+        char escaped_state[AMS_MAX_FIELD_LENGTH * 2];
+        char escaped_postal[AMS_MAX_FIELD_LENGTH * 2];
+        json_escape(escaped_id, sizeof(escaped_id), candidate->location->location_id);
+        json_escape(escaped_street, sizeof(escaped_street), candidate->location->street);
+        json_escape(escaped_city, sizeof(escaped_city), candidate->location->city);
+        json_escape(escaped_state, sizeof(escaped_state), candidate->location->state);
+        json_escape(escaped_postal, sizeof(escaped_postal), candidate->location->postal_code);
+        char entry[AMS_LLM_PAYLOAD_LIMIT];
+        int entry_length = snprintf(
+            entry,
+            sizeof(entry),
             "%s{ \"location_id\": \"%s\", \"confidence\": %.3f, \"strategy\": \"%s\", \"street\": \"%s\", \"city\": \"%s\", \"state\": \"%s\", \"postal_code\": \"%s\" }",
             (i > 0) ? ", " : "",
-            candidate->location->location_id,
+            escaped_id,
             candidate->confidence,
             candidate->strategy,
-            candidate->location->street,
-            candidate->location->city,
-            candidate->location->state,
-            candidate->location->postal_code);
-    }
-    if (offset >= sizeof(payload) - 1) {
-        payload[sizeof(payload) - 2] = '\0';
+            escaped_street,
+            escaped_city,
+            escaped_state,
+            escaped_postal);
+        if (entry_length < 0 || offset + (size_t)entry_length + 4 > sizeof(payload)) {
+            break;
+        }
+        memcpy(payload + offset, entry, (size_t)entry_length + 1);
+        offset += (size_t)entry_length;
+        const char *candidate_id = candidate->location->location_id;
+        cache_key = ams_hash_bytes(cache_key, candidate_id, strlen(candidate_id) + 1);
     }
     strncat(payload, "] }", sizeof(payload) - strlen(payload) - 1);
 
-    char template_path[] = "/tmp/ams-llm-XXXXXX";
-    int fd = mkstemp(template_path);
-    if (fd < 0) {
-        return;
-    }
-
-    ssize_t written = write(fd, payload, strlen(payload));
-    (void)written;
-    close(fd);
-
-    char command[AMS_MAX_FIELD_LENGTH + sizeof(template_path) + 2];
-    snprintf(command, sizeof(command), "%s %s", config->llm_command, template_path);
-
-    FILE *pipe = popen(command, "r");
-    if (pipe == NULL) {
-        unlink(template_path);
-        return;
-    }
-
-    char response[256];
-    if (fgets(response, sizeof(response), pipe) == NULL) {
-        pclose(pipe);
-        unlink(template_path);
-        return;
-    }
-    pclose(pipe);
-    unlink(template_path);
-
-    trim_whitespace(response);
-    if (response[0] == '\0') {
-        return;
-    }
-
-    char *token = strtok(response, " ");
-    char location_id[AMS_MAX_ID_LENGTH] = {0};
+    char location_id[AMS_MAX_ID_LENGTH];
     double confidence = 0.0;
-    while (token != NULL) {
-        if (strncmp(token, "location_id=", 12) == 0) {
-            copy_field(location_id, sizeof(location_id), token + 12);
-        } else if (strncmp(token, "confidence=", 11) == 0) {
-            confidence = atof(token + 11);
+    if (llm_cache_lookup(&llm_cache, cache_key, location_id, sizeof(location_id), &confidence) == 0) {
+        atomic_fetch_add_explicit(&llm_cache_hit_count, 1, memory_order_relaxed);
+    } else {
+        long remaining_ms = budget_remaining_ms(context);
+        if (remaining_ms >= 0 && remaining_ms < AMS_LLM_MIN_BUDGET_MS) {
+            result->degraded = 1;
+            return;
+        }
+        atomic_fetch_add_explicit(&llm_invoked_count, 1, memory_order_relaxed);
+        char response[AMS_LLM_RESPONSE_LIMIT];
+        int timeout_ms = remaining_ms > 0 && remaining_ms < INT32_MAX ? (int)remaining_ms : 0;
+        if (llm_pool_call(&llm_pool, payload, response, sizeof(response), timeout_ms) != 0) {
+            return;
+        }
+        if (parse_llm_response(response, location_id, sizeof(location_id), &confidence) != 0) {
+            return;
         }
-        token = strtok(NULL, " ");
+        llm_cache_store(&llm_cache, cache_key, location_id, confidence);
     }
 
     if (location_id[0] == '\0' || confidence <= 0.0) {
@@ -1376,33 +2702,154 @@ static void strategy_llm(
     if (confidence < config->llm_min_confidence) {
         return;
     }
+    if (confidence > 1.0) {
+        confidence = 1.0;
+    }
 
-    const LocationRecord *location = find_location_by_id(store, location_id);
+    const LocationRecord *location = location_store_find(store, location_id);
     if (location == NULL) {
         return;
     }
 
-    ScoreBreakdown breakdown = score_components(&result->record_components, &location->components, 0);
+    ComponentScores scores = score_location(context, location, 0);
     add_candidate(
         result,
         location,
         confidence,
         "llm",
         "llm_ranked",
-        &breakdown,
+        &scores,
         config->max_candidates);
 }
 
-static const LocationRecord *find_location_by_id(
-    const LocationStore *store,
-    const char *location_id) {
-    if (store == NULL || location_id == NULL) {
-        return NULL;
+static int llm_result_ambiguous(const MatchResult *result, const MatcherConfig *config) {
+    double best = -1.0;
+    double runner_up = -1.0;
+    for (size_t i = 0; i < result->count; ++i) {
+        double confidence = result->items[i].confidence;
+        if (confidence > best) {
+            runner_up = best;
+            best = confidence;
+        } else if (confidence > runner_up) {
+            runner_up = confidence;
+        }
+    }
+    if (best >= 1.0) {
+        return 0;
+    }
+    if (best >= config->llm_uncertain_min && best < config->llm_uncertain_max) {
+        return 1;
+    }
+    return runner_up >= 0.0 && best - runner_up < config->llm_margin_delta;
+}
+
+static uint64_t llm_query_key(const AddressComponents *components) {
+    const char *parts[] = {
+        components->street_number,
+        components->street_direction,
+        components->street_name,
+        components->street_suffix,
+        components->unit,
+        components->city,
+        components->state,
+        components->postal_code};
+    uint64_t key = 0;
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); ++i) {
+        key = ams_hash_bytes(key, parts[i], strlen(parts[i]) + 1);
+    }
+    return key;
+}
+
+static uint64_t location_store_fingerprint(const LocationStore *store) {
+    uint64_t fingerprint = 0;
+    if (store == NULL) {
+        return fingerprint;
     }
     for (size_t i = 0; i < store->count; ++i) {
-        if (strcmp(store->items[i].location_id, location_id) == 0) {
-            return &store->items[i];
+        const LocationRecord *record = &store->items[i];
+        fingerprint = ams_hash_bytes(fingerprint, record->location_id, strlen(record->location_id) + 1);
+        fingerprint = ams_hash_bytes(fingerprint, record->street, strlen(record->street) + 1);
+        fingerprint = ams_hash_bytes(fingerprint, record->city, strlen(record->city) + 1);
+        fingerprint = ams_hash_bytes(fingerprint, record->state, strlen(record->state) + 1);
+        fingerprint = ams_hash_bytes(fingerprint, record->postal_code, strlen(record->postal_code) + 1);
+    }
+    return fingerprint;
+}
+
+static int parse_llm_response(const char *response, char *location_id, size_t location_id_size, double *confidence) {
+    location_id[0] = '\0';
+    *confidence = 0.0;
+
+    size_t id_length = 0;
+    size_t confidence_length = 0;
+    const char *id_value = llm_response_field(response, "location_id", &id_length);
+    const char *confidence_value = llm_response_field(response, "confidence", &confidence_length);
+    if (id_value == NULL || confidence_value == NULL || id_length == 0 || id_length >= location_id_size) {
+        return -1;
+    }
+    memcpy(location_id, id_value, id_length);
+    location_id[id_length] = '\0';
+
+    char number[32];
+    if (confidence_length == 0 || confidence_length >= sizeof(number)) {
+        return -1;
+    }
+    memcpy(number, confidence_value, confidence_length);
+    number[confidence_length] = '\0';
+    *confidence = atof(number);
+    return 0;
+}
+
+static const char *llm_response_field(const char *response, const char *name, size_t *length) {
+    size_t name_length = strlen(name);
+    const char *value = NULL;
+    for (const char *cursor = strstr(response, name); cursor != NULL; cursor = strstr(cursor + name_length, name)) {
+        const char *after = cursor + name_length;
+        if (cursor > response && cursor[-1] == '"' && *after == '"') {
+            after += 1 + strspn(after + 1, " \t");
+            if (*after == ':') {
+                value = after + 1 + strspn(after + 1, " \t");
+                break;
+            }
+        } else if (*after == '=' && (cursor == response || cursor[-1] == ' ' || cursor[-1] == '\t')) {
+            value = after + 1;
+            break;
         }
     }
-    return NULL;
+    if (value == NULL) {
+        return NULL;
+    }
+    if (*value == '"') {
+        ++value;
+        *length = strcspn(value, "\"");
+    } else {
+        *length = strcspn(value, " \t\r,}");
+    }
+    return value;
+}
+
+static void json_escape(char *dest, size_t dest_size, const char *src) {
+    if (dest == NULL || dest_size == 0) {
+        return;
+    }
+    size_t offset = 0;
+    dest[0] = '\0';
+    if (src == NULL) {
+        src = "";
+    }
+    for (size_t i = 0; src[i] != '\0' && offset + 1 < dest_size; ++i) {
+        unsigned char c = (unsigned char)src[i];
+        if (c == '"' || c == '\\') {
+            if (offset + 2 >= dest_size) {
+                break;
+            }
+            dest[offset++] = '\\';
+            dest[offset++] = (char)c;
+        } else if (c < 0x20) {
+            continue;
+        } else {
+            dest[offset++] = (char)c;
+        }
+    }
+    dest[offset] = '\0';
 }
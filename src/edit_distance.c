@@ -0,0 +1,371 @@
+#include "edit_distance.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AMS_EDIT_DISTANCE_X86 1
+#endif
+
+#define AMS_EDIT_DISTANCE_STACK_COLUMNS 256
+#define AMS_EDIT_DISTANCE_WORD_BITS 64
+#define AMS_EDIT_DISTANCE_LANE_BITS 32
+
+static int myers_distance(
+    const char *pattern,
+    size_t pattern_length,
+    const char *text,
+    size_t text_length,
+    int max_distance);
+static int banded_distance(
+    const char *left,
+    size_t left_length,
+    const char *right,
+    size_t right_length,
+    int max_distance);
+static void batch_scalar(
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count,
+    int *distances);
+#ifdef AMS_EDIT_DISTANCE_X86
+static void batch_sse41(
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count,
+    int *distances);
+static void batch_avx2(
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count,
+    int *distances);
+#endif
+
+int edit_distance(const char *left, size_t left_length, const char *right, size_t right_length) {
+    size_t longest = left_length > right_length ? left_length : right_length;
+    return edit_distance_bounded(left, left_length, right, right_length, (int)longest);
+}
+
+int edit_distance_bounded(
+    const char *left,
+    size_t left_length,
+    const char *right,
+    size_t right_length,
+    int max_distance) {
+    if (max_distance < 0) {
+        return INT_MAX;
+    }
+    size_t gap = left_length > right_length ? left_length - right_length : right_length - left_length;
+    if (gap > (size_t)max_distance) {
+        return max_distance + 1;
+    }
+    if (left_length == 0 || right_length == 0) {
+        return (int)gap;
+    }
+    if (left_length <= AMS_EDIT_DISTANCE_WORD_BITS && left_length <= right_length) {
+        return myers_distance(left, left_length, right, right_length, max_distance);
+    }
+    if (right_length <= AMS_EDIT_DISTANCE_WORD_BITS) {
+        return myers_distance(right, right_length, left, left_length, max_distance);
+    }
+    return banded_distance(left, left_length, right, right_length, max_distance);
+}
+
+void edit_distance_batch(
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count,
+    int *distances) {
+    if (count == 0) {
+        return;
+    }
+#ifdef AMS_EDIT_DISTANCE_X86
+    if (query_length > 0 && query_length <= AMS_EDIT_DISTANCE_LANE_BITS) {
+        if (__builtin_cpu_supports("avx2")) {
+            batch_avx2(query, query_length, candidates, candidate_lengths, count, distances);
+            return;
+        }
+        if (__builtin_cpu_supports("sse4.1")) {
+            batch_sse41(query, query_length, candidates, candidate_lengths, count, distances);
+            return;
+        }
+    }
+#endif
+    batch_scalar(query, query_length, candidates, candidate_lengths, count, distances);
+}
+
+static int myers_distance(
+    const char *pattern,
+    size_t pattern_length,
+    const char *text,
+    size_t text_length,
+    int max_distance) {
+    static _Thread_local uint64_t peq[256];
+    for (size_t i = 0; i < pattern_length; ++i) {
+        peq[(unsigned char)pattern[i]] |= (uint64_t)1 << i;
+    }
+
+    uint64_t high_bit = (uint64_t)1 << (pattern_length - 1);
+    uint64_t positive = pattern_length == AMS_EDIT_DISTANCE_WORD_BITS ? ~(uint64_t)0 : (high_bit << 1) - 1;
+    uint64_t negative = 0;
+    int score = (int)pattern_length;
+    for (size_t j = 0; j < text_length; ++j) {
+        uint64_t equal = peq[(unsigned char)text[j]];
+        uint64_t vertical = equal | negative;
+        uint64_t horizontal = (((equal & positive) + positive) ^ positive) | equal;
+        uint64_t horizontal_positive = negative | ~(horizontal | positive);
+        uint64_t horizontal_negative = positive & horizontal;
+        if (horizontal_positive & high_bit) {
+            ++score;
+        } else if (horizontal_negative & high_bit) {
+            --score;
+        }
+        if (score - (int)(text_length - j - 1) > max_distance) {
+            score = max_distance + 1;
+            break;
+        }
+        horizontal_positive = (horizontal_positive << 1) | 1;
+        horizontal_negative <<= 1;
+        positive = horizontal_negative | ~(vertical | horizontal_positive);
+        negative = horizontal_positive & vertical;
+    }
+
+    for (size_t i = 0; i < pattern_length; ++i) {
+        peq[(unsigned char)pattern[i]] = 0;
+    }
+    return score <= max_distance ? score : max_distance + 1;
+}
+
+static int banded_distance(
+    const char *left,
+    size_t left_length,
+    const char *right,
+    size_t right_length,
+    int max_distance) {
+    int stack_rows[2 * (AMS_EDIT_DISTANCE_STACK_COLUMNS + 1)];
+    int *rows = stack_rows;
+    if (right_length > AMS_EDIT_DISTANCE_STACK_COLUMNS) {
+        rows = malloc(2 * (right_length + 1) * sizeof(int));
+        if (rows == NULL) {
+            return max_distance + 1;
+        }
+    }
+    int *prev = rows;
+    int *curr = rows + right_length + 1;
+    int beyond = max_distance + 1;
+    size_t band = (size_t)max_distance;
+
+    for (size_t j = 0; j <= right_length; ++j) {
+        prev[j] = j <= band ? (int)j : beyond;
+    }
+
+    int exceeded = 0;
+    for (size_t i = 1; i <= left_length && !exceeded; ++i) {
+        size_t low = i > band ? i - band : 1;
+        size_t high = i + band < right_length ? i + band : right_length;
+        curr[0] = i <= band ? (int)i : beyond;
+        if (low > 1) {
+            curr[low - 1] = beyond;
+        }
+
+        int row_minimum = curr[0];
+        for (size_t j = low; j <= high; ++j) {
+            int cost = (left[i - 1] == right[j - 1]) ? 0 : 1;
+            int deletion = prev[j] + 1;
+            int insertion = curr[j - 1] + 1;
+            int substitution = prev[j - 1] + cost;
+            int minimum = deletion < insertion ? deletion : insertion;
+            if (substitution < minimum) {
+                minimum = substitution;
+            }
+            if (minimum > beyond) {
+                minimum = beyond;
+            }
+            curr[j] = minimum;
+            if (minimum < row_minimum) {
+                row_minimum = minimum;
+            }
+        }
+        if (high < right_length) {
+            curr[high + 1] = beyond;
+        }
+        exceeded = row_minimum > max_distance;
+
+        int *tmp = prev;
+        prev = curr;
+        curr = tmp;
+    }
+
+    int distance = (!exceeded && prev[right_length] <= max_distance) ? prev[right_length] : beyond;
+    if (rows != stack_rows) {
+        free(rows);
+    }
+    return distance;
+}
+
+static void batch_scalar(
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count,
+    int *distances) {
+    for (size_t i = 0; i < count; ++i) {
+        distances[i] = edit_distance(query, query_length, candidates[i], candidate_lengths[i]);
+    }
+}
+
+#ifdef AMS_EDIT_DISTANCE_X86
+__attribute__((target("sse4.1"))) static void batch_sse41(
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count,
+    int *distances) {
+    uint32_t peq[256] = {0};
+    for (size_t i = 0; i < query_length; ++i) {
+        peq[(unsigned char)query[i]] |= (uint32_t)1 << i;
+    }
+    uint32_t high = (uint32_t)1 << (query_length - 1);
+    uint32_t mask = query_length == AMS_EDIT_DISTANCE_LANE_BITS ? ~(uint32_t)0 : (high << 1) - 1;
+    const __m128i high_bit = _mm_set1_epi32((int)high);
+    const __m128i ones = _mm_set1_epi32(-1);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (size_t base = 0; base < count; base += 4) {
+        size_t lanes = count - base < 4 ? count - base : 4;
+        size_t longest = 0;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            if (candidate_lengths[base + lane] > longest) {
+                longest = candidate_lengths[base + lane];
+            }
+        }
+
+        __m128i positive = _mm_set1_epi32((int)mask);
+        __m128i negative = zero;
+        __m128i score = _mm_set1_epi32((int)query_length);
+        for (size_t j = 0; j < longest; ++j) {
+            uint32_t equal_lanes[4] = {0, 0, 0, 0};
+            uint32_t active_lanes[4] = {0, 0, 0, 0};
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                if (j < candidate_lengths[base + lane]) {
+                    equal_lanes[lane] = peq[(unsigned char)candidates[base + lane][j]];
+                    active_lanes[lane] = UINT32_MAX;
+                }
+            }
+            __m128i equal = _mm_loadu_si128((const __m128i *)equal_lanes);
+            __m128i active = _mm_loadu_si128((const __m128i *)active_lanes);
+
+            __m128i vertical = _mm_or_si128(equal, negative);
+            __m128i sum = _mm_add_epi32(_mm_and_si128(equal, positive), positive);
+            __m128i horizontal = _mm_or_si128(_mm_xor_si128(sum, positive), equal);
+            __m128i horizontal_positive =
+                _mm_or_si128(negative, _mm_xor_si128(_mm_or_si128(horizontal, positive), ones));
+            __m128i horizontal_negative = _mm_and_si128(positive, horizontal);
+
+            __m128i up = _mm_cmpeq_epi32(_mm_and_si128(horizontal_positive, high_bit), high_bit);
+            __m128i down = _mm_cmpeq_epi32(_mm_and_si128(horizontal_negative, high_bit), high_bit);
+            __m128i delta = _mm_sub_epi32(_mm_and_si128(up, one), _mm_and_si128(down, one));
+            score = _mm_add_epi32(score, _mm_and_si128(delta, active));
+
+            horizontal_positive = _mm_or_si128(_mm_slli_epi32(horizontal_positive, 1), one);
+            horizontal_negative = _mm_slli_epi32(horizontal_negative, 1);
+            __m128i next_positive =
+                _mm_or_si128(horizontal_negative, _mm_xor_si128(_mm_or_si128(vertical, horizontal_positive), ones));
+            __m128i next_negative = _mm_and_si128(horizontal_positive, vertical);
+            positive = _mm_blendv_epi8(positive, next_positive, active);
+            negative = _mm_blendv_epi8(negative, next_negative, active);
+        }
+
+        int32_t scores[4];
+        _mm_storeu_si128((__m128i *)scores, score);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            distances[base + lane] = candidate_lengths[base + lane] == 0 ? (int)query_length : scores[lane];
+        }
+    }
+}
+
+__attribute__((target("avx2"))) static void batch_avx2(
+    const char *query,
+    size_t query_length,
+    const char *const *candidates,
+    const size_t *candidate_lengths,
+    size_t count,
+    int *distances) {
+    uint32_t peq[256] = {0};
+    for (size_t i = 0; i < query_length; ++i) {
+        peq[(unsigned char)query[i]] |= (uint32_t)1 << i;
+    }
+    uint32_t high = (uint32_t)1 << (query_length - 1);
+    uint32_t mask = query_length == AMS_EDIT_DISTANCE_LANE_BITS ? ~(uint32_t)0 : (high << 1) - 1;
+    const __m256i high_bit = _mm256_set1_epi32((int)high);
+    const __m256i ones = _mm256_set1_epi32(-1);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (size_t base = 0; base < count; base += 8) {
+        size_t lanes = count - base < 8 ? count - base : 8;
+        size_t longest = 0;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            if (candidate_lengths[base + lane] > longest) {
+                longest = candidate_lengths[base + lane];
+            }
+        }
+
+        __m256i positive = _mm256_set1_epi32((int)mask);
+        __m256i negative = zero;
+        __m256i score = _mm256_set1_epi32((int)query_length);
+        for (size_t j = 0; j < longest; ++j) {
+            uint32_t equal_lanes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+            uint32_t active_lanes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                if (j < candidate_lengths[base + lane]) {
+                    equal_lanes[lane] = peq[(unsigned char)candidates[base + lane][j]];
+                    active_lanes[lane] = UINT32_MAX;
+                }
+            }
+            __m256i equal = _mm256_loadu_si256((const __m256i *)equal_lanes);
+            __m256i active = _mm256_loadu_si256((const __m256i *)active_lanes);
+
+            __m256i vertical = _mm256_or_si256(equal, negative);
+            __m256i sum = _mm256_add_epi32(_mm256_and_si256(equal, positive), positive);
+            __m256i horizontal = _mm256_or_si256(_mm256_xor_si256(sum, positive), equal);
+            __m256i horizontal_positive =
+                _mm256_or_si256(negative, _mm256_xor_si256(_mm256_or_si256(horizontal, positive), ones));
+            __m256i horizontal_negative = _mm256_and_si256(positive, horizontal);
+
+            __m256i up = _mm256_cmpeq_epi32(_mm256_and_si256(horizontal_positive, high_bit), high_bit);
+            __m256i down = _mm256_cmpeq_epi32(_mm256_and_si256(horizontal_negative, high_bit), high_bit);
+            __m256i delta = _mm256_sub_epi32(_mm256_and_si256(up, one), _mm256_and_si256(down, one));
+            score = _mm256_add_epi32(score, _mm256_and_si256(delta, active));
+
+            horizontal_positive = _mm256_or_si256(_mm256_slli_epi32(horizontal_positive, 1), one);
+            horizontal_negative = _mm256_slli_epi32(horizontal_negative, 1);
+            __m256i next_positive = _mm256_or_si256(
+                horizontal_negative,
+                _mm256_xor_si256(_mm256_or_si256(vertical, horizontal_positive), ones));
+            __m256i next_negative = _mm256_and_si256(horizontal_positive, vertical);
+            positive = _mm256_blendv_epi8(positive, next_positive, active);
+            negative = _mm256_blendv_epi8(negative, next_negative, active);
+        }
+
+        int32_t scores[8];
+        _mm256_storeu_si256((__m256i *)scores, score);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            distances[base + lane] = candidate_lengths[base + lane] == 0 ? (int)query_length : scores[lane];
+        }
+    }
+}
+#endif
@@ -0,0 +1,133 @@
+#include "json_writer.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define AMS_JSON_FIXED_LIMIT 1e15
+
+static const uint64_t fixed_scales[AMS_JSON_MAX_DECIMALS + 1] = {1, 10, 100, 1000};
+
+void json_writer_init(JsonWriter *writer, char *buffer, size_t size) {
+    if (writer == NULL) {
+        return;
+    }
+    writer->buffer = buffer;
+    writer->size = buffer != NULL ? size : 0;
+    writer->length = 0;
+    writer->truncated = 0;
+    if (writer->size > 0) {
+        buffer[0] = '\0';
+    }
+}
+
+void json_writer_append(JsonWriter *writer, const char *data, size_t length) {
+    if (writer == NULL || writer->truncated || length == 0) {
+        return;
+    }
+    size_t available = writer->size > writer->length ? writer->size - writer->length - 1 : 0;
+    if (length > available) {
+        length = available;
+        writer->truncated = 1;
+    }
+    memcpy(writer->buffer + writer->length, data, length);
+    writer->length += length;
+    writer->buffer[writer->length] = '\0';
+}
+
+void json_writer_append_raw(JsonWriter *writer, const char *text) {
+    if (text != NULL) {
+        json_writer_append(writer, text, strlen(text));
+    }
+}
+
+void json_writer_append_escaped(JsonWriter *writer, const char *value, size_t limit) {
+    if (value == NULL) {
+        return;
+    }
+    size_t produced = 0;
+    size_t start = 0;
+    size_t i = 0;
+    for (; value[i] != '\0' && produced < limit; ++i) {
+        unsigned char c = (unsigned char)value[i];
+        char escape = 0;
+        if (c == '"' || c == '\\') {
+            escape = (char)c;
+        } else if (c == '\n') {
+            escape = 'n';
+        } else if (c == '\r') {
+            escape = 'r';
+        } else if (c == '\t') {
+            escape = 't';
+        } else if (c >= 0x20) {
+            ++produced;
+            continue;
+        }
+
+        json_writer_append(writer, value + start, i - start);
+        start = i + 1;
+        if (escape == 0) {
+            continue;
+        }
+        if (produced + 2 > limit) {
+            return;
+        }
+        char pair[2] = {'\\', escape};
+        json_writer_append(writer, pair, sizeof(pair));
+        produced += 2;
+    }
+    json_writer_append(writer, value + start, i - start);
+}
+
+void json_writer_append_fixed(JsonWriter *writer, double value, int decimals) {
+    if (writer == NULL) {
+        return;
+    }
+    char text[32];
+    if (decimals < 0 || decimals > AMS_JSON_MAX_DECIMALS || LDBL_MANT_DIG < 64 ||
+        !(value < AMS_JSON_FIXED_LIMIT && value > -AMS_JSON_FIXED_LIMIT)) {
+        int written = snprintf(text, sizeof(text), "%.*f", decimals, value);
+        if (written > 0) {
+            json_writer_append(writer, text, (size_t)written < sizeof(text) ? (size_t)written : sizeof(text) - 1);
+        }
+        return;
+    }
+
+    size_t length = 0;
+    if (signbit(value)) {
+        text[length++] = '-';
+        value = -value;
+    }
+
+    uint64_t scale = fixed_scales[decimals];
+    long double scaled = (long double)value * (long double)scale;
+    uint64_t units = (uint64_t)scaled;
+    long double remainder = scaled - (long double)units;
+    if (remainder > 0.5L || (remainder == 0.5L && (units & 1) != 0)) {
+        ++units;
+    }
+
+    char digits[24];
+    size_t digit_count = 0;
+    uint64_t whole = units / scale;
+    do {
+        digits[digit_count++] = (char)('0' + whole % 10);
+        whole /= 10;
+    } while (whole != 0);
+    while (digit_count > 0) {
+        text[length++] = digits[--digit_count];
+    }
+
+    if (decimals > 0) {
+        uint64_t fraction = units % scale;
+        text[length++] = '.';
+        for (int i = decimals - 1; i >= 0; --i) {
+            text[length + (size_t)i] = (char)('0' + fraction % 10);
+            fraction /= 10;
+        }
+        length += (size_t)decimals;
+    }
+    json_writer_append(writer, text, length);
+}
@@ -0,0 +1,260 @@
+#include "llm_cache.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define AMS_LLM_CACHE_LINE_LENGTH 256
+#define AMS_LLM_CACHE_COMPACT_FACTOR 4
+#define AMS_LLM_CACHE_HEADER "ams-llm-cache 2"
+
+static int cache_load(LlmCache *cache);
+static int cache_compact(LlmCache *cache);
+static size_t cache_find_slot(const LlmCache *cache, uint64_t key);
+static void cache_remove_slot(LlmCache *cache, size_t slot);
+static LlmCacheEntry *cache_insert(LlmCache *cache, uint64_t key, const char *location_id, double confidence);
+static int cache_parse_record(char *line, uint64_t *key, double *confidence, char **location_id);
+static void cache_write_record(FILE *file, const LlmCacheEntry *entry);
+
+int llm_cache_open(LlmCache *cache, const char *path, size_t capacity, uint64_t fingerprint) {
+    if (cache == NULL) {
+        return -1;
+    }
+    memset(cache, 0, sizeof(*cache));
+    if (capacity == 0) {
+        return 0;
+    }
+    if (capacity > UINT32_MAX / 2) {
+        return -1;
+    }
+
+    size_t slot_count = 1;
+    while (slot_count < capacity * 2) {
+        slot_count <<= 1;
+    }
+    cache->entries = calloc(capacity, sizeof(LlmCacheEntry));
+    cache->slots = calloc(slot_count, sizeof(uint32_t));
+    if (path != NULL && path[0] != '\0') {
+        size_t path_length = strlen(path);
+        cache->path = malloc(path_length + 1);
+        if (cache->path != NULL) {
+            memcpy(cache->path, path, path_length + 1);
+        }
+    }
+    if (cache->entries == NULL || cache->slots == NULL || (path != NULL && path[0] != '\0' && cache->path == NULL) ||
+        pthread_mutex_init(&cache->lock, NULL) != 0) {
+        free(cache->entries);
+        free(cache->slots);
+        free(cache->path);
+        memset(cache, 0, sizeof(*cache));
+        return -1;
+    }
+    cache->slot_mask = slot_count - 1;
+    cache->capacity = capacity;
+    cache->fingerprint = fingerprint;
+
+    if (cache->path != NULL && cache_load(cache) != 0) {
+        llm_cache_close(cache);
+        return -1;
+    }
+    return 0;
+}
+
+void llm_cache_close(LlmCache *cache) {
+    if (cache == NULL || cache->capacity == 0) {
+        return;
+    }
+    if (cache->journal != NULL) {
+        fclose(cache->journal);
+    }
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->entries);
+    free(cache->slots);
+    free(cache->path);
+    memset(cache, 0, sizeof(*cache));
+}
+
+int llm_cache_lookup(LlmCache *cache, uint64_t key, char *location_id, size_t location_id_size, double *confidence) {
+    if (cache == NULL || cache->capacity == 0 || location_id == NULL || location_id_size == 0 || confidence == NULL) {
+        return -1;
+    }
+
+    int status = -1;
+    pthread_mutex_lock(&cache->lock);
+    uint32_t index = cache->slots[cache_find_slot(cache, key)];
+    if (index != 0) {
+        LlmCacheEntry *entry = &cache->entries[index - 1];
+        entry->referenced = 1;
+        snprintf(location_id, location_id_size, "%s", entry->location_id);
+        *confidence = entry->confidence;
+        status = 0;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return status;
+}
+
+void llm_cache_store(LlmCache *cache, uint64_t key, const char *location_id, double confidence) {
+    if (cache == NULL || cache->capacity == 0 || location_id == NULL) {
+        return;
+    }
+    size_t id_length = strlen(location_id);
+    if (id_length == 0 || id_length >= AMS_LLM_CACHE_ID_LENGTH || strchr(location_id, '\n') != NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    LlmCacheEntry *entry = cache_insert(cache, key, location_id, confidence);
+    if (cache->journal != NULL) {
+        cache_write_record(cache->journal, entry);
+        fflush(cache->journal);
+        if (++cache->journal_records > cache->capacity * AMS_LLM_CACHE_COMPACT_FACTOR) {
+            cache_compact(cache);
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+static int cache_load(LlmCache *cache) {
+    FILE *file = fopen(cache->path, "r");
+    if (file == NULL) {
+        return errno == ENOENT ? cache_compact(cache) : -1;
+    }
+
+    char line[AMS_LLM_CACHE_LINE_LENGTH];
+    uint64_t stored_fingerprint = 0;
+    int valid = fgets(line, sizeof(line), file) != NULL &&
+                sscanf(line, AMS_LLM_CACHE_HEADER " %" SCNx64, &stored_fingerprint) == 1 &&
+                stored_fingerprint == cache->fingerprint;
+    while (valid && fgets(line, sizeof(line), file) != NULL) {
+        uint64_t key = 0;
+        double confidence = 0.0;
+        char *location_id = NULL;
+        if (cache_parse_record(line, &key, &confidence, &location_id) == 0) {
+            LlmCacheEntry *entry = cache_insert(cache, key, location_id, confidence);
+            entry->referenced = 0;
+        }
+    }
+    fclose(file);
+    return cache_compact(cache);
+}
+
+static int cache_compact(LlmCache *cache) {
+    if (cache->journal != NULL) {
+        fclose(cache->journal);
+        cache->journal = NULL;
+    }
+
+    size_t path_length = strlen(cache->path);
+    char *temporary = malloc(path_length + 5);
+    if (temporary == NULL) {
+        return -1;
+    }
+    memcpy(temporary, cache->path, path_length);
+    memcpy(temporary + path_length, ".tmp", 5);
+
+    FILE *file = fopen(temporary, "w");
+    if (file == NULL) {
+        free(temporary);
+        return -1;
+    }
+    fprintf(file, AMS_LLM_CACHE_HEADER " %016" PRIx64 "\n", cache->fingerprint);
+    for (size_t i = 0; i < cache->count; ++i) {
+        cache_write_record(file, &cache->entries[i]);
+    }
+    int failed = fflush(file) != 0 || ferror(file);
+    failed = fclose(file) != 0 || failed;
+    if (!failed) {
+        failed = rename(temporary, cache->path) != 0;
+    }
+    if (failed) {
+        unlink(temporary);
+    }
+    free(temporary);
+    if (failed) {
+        return -1;
+    }
+
+    cache->journal = fopen(cache->path, "a");
+    cache->journal_records = cache->count;
+    return cache->journal != NULL ? 0 : -1;
+}
+
+static size_t cache_find_slot(const LlmCache *cache, uint64_t key) {
+    size_t slot = (size_t)key & cache->slot_mask;
+    while (cache->slots[slot] != 0 && cache->entries[cache->slots[slot] - 1].key != key) {
+        slot = (slot + 1) & cache->slot_mask;
+    }
+    return slot;
+}
+
+static void cache_remove_slot(LlmCache *cache, size_t slot) {
+    size_t hole = slot;
+    size_t next = (hole + 1) & cache->slot_mask;
+    while (cache->slots[next] != 0) {
+        size_t home = (size_t)cache->entries[cache->slots[next] - 1].key & cache->slot_mask;
+        if (((next - home) & cache->slot_mask) >= ((next - hole) & cache->slot_mask)) {
+            cache->slots[hole] = cache->slots[next];
+            hole = next;
+        }
+        next = (next + 1) & cache->slot_mask;
+    }
+    cache->slots[hole] = 0;
+}
+
+static LlmCacheEntry *cache_insert(LlmCache *cache, uint64_t key, const char *location_id, double confidence) {
+    size_t slot = cache_find_slot(cache, key);
+    LlmCacheEntry *entry = NULL;
+    if (cache->slots[slot] != 0) {
+        entry = &cache->entries[cache->slots[slot] - 1];
+    } else {
+        size_t index = cache->count;
+        if (cache->count < cache->capacity) {
+            ++cache->count;
+        } else {
+            while (cache->entries[cache->hand].referenced) {
+                cache->entries[cache->hand].referenced = 0;
+                cache->hand = (cache->hand + 1) % cache->capacity;
+            }
+            index = cache->hand;
+            cache->hand = (cache->hand + 1) % cache->capacity;
+            cache_remove_slot(cache, cache_find_slot(cache, cache->entries[index].key));
+            slot = cache_find_slot(cache, key);
+        }
+        entry = &cache->entries[index];
+        entry->key = key;
+        cache->slots[slot] = (uint32_t)index + 1;
+    }
+    entry->confidence = confidence;
+    entry->referenced = 0;
+    snprintf(entry->location_id, sizeof(entry->location_id), "%s", location_id);
+    return entry;
+}
+
+static int cache_parse_record(char *line, uint64_t *key, double *confidence, char **location_id) {
+    size_t length = strlen(line);
+    if (length == 0 || line[length - 1] != '\n') {
+        return -1;
+    }
+    line[--length] = '\0';
+
+    char *cursor = NULL;
+    errno = 0;
+    *key = (uint64_t)strtoull(line, &cursor, 16);
+    if (errno != 0 || cursor == line || *cursor != ' ') {
+        return -1;
+    }
+    char *value = cursor + 1;
+    *confidence = strtod(value, &cursor);
+    if (cursor == value || *cursor != ' ') {
+        return -1;
+    }
+    *location_id = cursor + 1;
+    size_t id_length = strlen(*location_id);
+    return id_length > 0 && id_length < AMS_LLM_CACHE_ID_LENGTH ? 0 : -1;
+}
+
+static void cache_write_record(FILE *file, const LlmCacheEntry *entry) {
+    fprintf(file, "%016" PRIx64 " %.6f %s\n", entry->key, entry->confidence, entry->location_id);
+}
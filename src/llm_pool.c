@@ -0,0 +1,588 @@
+#define _GNU_SOURCE
+#include "llm_pool.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static int pool_call_batched(
+    LlmPool *pool,
+    const char *request,
+    char *response,
+    size_t response_size,
+    const struct timespec *deadline);
+static void pool_lead_batch(LlmPool *pool, const struct timespec *deadline);
+static char *pool_batch_request(LlmPending **batch, size_t count, size_t *response_size);
+static void pool_deliver(LlmPending *pending, const char *response, size_t length);
+static void pool_split_batch(const char *response, LlmPending **batch, size_t count);
+static void pool_unlink_pending(LlmPool *pool, LlmPending *pending);
+static int pool_exchange(
+    LlmPool *pool,
+    const char *request,
+    char *response,
+    size_t response_size,
+    const struct timespec *deadline);
+static LlmWorker *pool_acquire(LlmPool *pool, const struct timespec *deadline);
+static void pool_release(LlmPool *pool, LlmWorker *worker);
+static int worker_spawn(LlmWorker *worker, const char *command);
+static void worker_stop(LlmWorker *worker);
+static int worker_write(LlmWorker *worker, const char *data, size_t length, const struct timespec *deadline);
+static int worker_read_line(LlmWorker *worker, char *response, size_t response_size, const struct timespec *deadline);
+static int remaining_ms(const struct timespec *deadline);
+static int deadline_before(const struct timespec *left, const struct timespec *right);
+static void deadline_after(struct timespec *deadline, int milliseconds);
+
+int llm_pool_start(
+    LlmPool *pool,
+    const char *command,
+    size_t worker_count,
+    int timeout_ms,
+    size_t batch_size,
+    int linger_ms) {
+    if (pool == NULL || command == NULL || command[0] == '\0') {
+        return -1;
+    }
+    if (worker_count == 0 || worker_count > AMS_LLM_POOL_MAX_WORKERS || timeout_ms <= 0) {
+        return -1;
+    }
+    if (batch_size == 0 || batch_size > AMS_LLM_POOL_MAX_BATCH || linger_ms < 0) {
+        return -1;
+    }
+    memset(pool, 0, sizeof(*pool));
+
+    size_t command_length = strlen(command);
+    pool->command = malloc(command_length + 1);
+    pool->workers = calloc(worker_count, sizeof(LlmWorker));
+    if (pool->command == NULL || pool->workers == NULL) {
+        free(pool->command);
+        free(pool->workers);
+        memset(pool, 0, sizeof(*pool));
+        return -1;
+    }
+    memcpy(pool->command, command, command_length + 1);
+
+    pthread_condattr_t attributes;
+    int failed = pthread_condattr_init(&attributes) != 0;
+    if (!failed) {
+        failed = pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC) != 0;
+        if (!failed && pthread_cond_init(&pool->available, &attributes) != 0) {
+            failed = 1;
+        } else if (!failed && pthread_cond_init(&pool->batch_ready, &attributes) != 0) {
+            pthread_cond_destroy(&pool->available);
+            failed = 1;
+        } else if (!failed && pthread_cond_init(&pool->batch_done, &attributes) != 0) {
+            pthread_cond_destroy(&pool->available);
+            pthread_cond_destroy(&pool->batch_ready);
+            failed = 1;
+        }
+        pthread_condattr_destroy(&attributes);
+    }
+    if (!failed && pthread_mutex_init(&pool->lock, NULL) != 0) {
+        pthread_cond_destroy(&pool->available);
+        pthread_cond_destroy(&pool->batch_ready);
+        pthread_cond_destroy(&pool->batch_done);
+        failed = 1;
+    }
+    if (failed) {
+        free(pool->command);
+        free(pool->workers);
+        memset(pool, 0, sizeof(*pool));
+        return -1;
+    }
+
+    pool->worker_count = worker_count;
+    pool->timeout_ms = timeout_ms;
+    pool->batch_size = batch_size;
+    pool->linger_ms = linger_ms;
+    for (size_t i = 0; i < worker_count; ++i) {
+        pool->workers[i].pid = -1;
+        pool->workers[i].request_fd = -1;
+        pool->workers[i].response_fd = -1;
+        worker_spawn(&pool->workers[i], pool->command);
+    }
+    pool->running = 1;
+    return 0;
+}
+
+void llm_pool_stop(LlmPool *pool) {
+    if (pool == NULL || !pool->running) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->running = 0;
+    pthread_cond_broadcast(&pool->available);
+    pthread_cond_broadcast(&pool->batch_ready);
+    for (;;) {
+        size_t busy = 0;
+        for (size_t i = 0; i < pool->worker_count; ++i) {
+            busy += pool->workers[i].busy ? 1 : 0;
+        }
+        if (busy == 0) {
+            break;
+        }
+        pthread_cond_wait(&pool->available, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->worker_count; ++i) {
+        worker_stop(&pool->workers[i]);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->available);
+    pthread_cond_destroy(&pool->batch_ready);
+    pthread_cond_destroy(&pool->batch_done);
+    free(pool->command);
+    free(pool->workers);
+    memset(pool, 0, sizeof(*pool));
+}
+
+int llm_pool_call(LlmPool *pool, const char *request, char *response, size_t response_size, int timeout_ms) {
+    if (pool == NULL || request == NULL || response == NULL || response_size == 0) {
+        return -1;
+    }
+    response[0] = '\0';
+    if (!pool->running || strchr(request, '\n') != NULL) {
+        return -1;
+    }
+
+    struct timespec deadline;
+    deadline_after(&deadline, timeout_ms > 0 && timeout_ms < pool->timeout_ms ? timeout_ms : pool->timeout_ms);
+    if (pool->batch_size > 1) {
+        return pool_call_batched(pool, request, response, response_size, &deadline);
+    }
+    return pool_exchange(pool, request, response, response_size, &deadline);
+}
+
+static int pool_call_batched(
+    LlmPool *pool,
+    const char *request,
+    char *response,
+    size_t response_size,
+    const struct timespec *deadline) {
+    LlmPending pending = {request, response, response_size, *deadline, -1, 0, NULL, NULL};
+    pthread_mutex_lock(&pool->lock);
+    if (pool->pending_tail != NULL) {
+        pool->pending_tail->next = &pending;
+    } else {
+        pool->pending_head = &pending;
+    }
+    pool->pending_tail = &pending;
+    if (++pool->pending_count >= pool->batch_size) {
+        pthread_cond_signal(&pool->batch_ready);
+    }
+
+    while (!pending.done) {
+        if (pending.claim == NULL && !pool->batch_leader) {
+            if (remaining_ms(deadline) == 0) {
+                pool_unlink_pending(pool, &pending);
+                break;
+            }
+            pool_lead_batch(pool, deadline);
+        } else if (pthread_cond_timedwait(&pool->batch_done, &pool->lock, deadline) == ETIMEDOUT &&
+                   !pending.done) {
+            if (pending.claim != NULL) {
+                *pending.claim = NULL;
+            } else {
+                pool_unlink_pending(pool, &pending);
+            }
+            break;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    if (!pending.done || pending.status != 0) {
+        response[0] = '\0';
+        return -1;
+    }
+    return 0;
+}
+
+static void pool_lead_batch(LlmPool *pool, const struct timespec *deadline) {
+    pool->batch_leader = 1;
+    struct timespec linger;
+    deadline_after(&linger, pool->linger_ms);
+    if (linger.tv_sec > deadline->tv_sec || (linger.tv_sec == deadline->tv_sec && linger.tv_nsec > deadline->tv_nsec)) {
+        linger = *deadline;
+    }
+    while (pool->running && pool->pending_count < pool->batch_size) {
+        if (pthread_cond_timedwait(&pool->batch_ready, &pool->lock, &linger) == ETIMEDOUT) {
+            break;
+        }
+    }
+
+    LlmPending *batch[AMS_LLM_POOL_MAX_BATCH];
+    size_t count = 0;
+    struct timespec earliest = *deadline;
+    while (pool->pending_head != NULL && count < pool->batch_size) {
+        LlmPending *entry = pool->pending_head;
+        pool->pending_head = entry->next;
+        entry->next = NULL;
+        entry->claim = &batch[count];
+        batch[count++] = entry;
+        --pool->pending_count;
+        if (deadline_before(&entry->deadline, &earliest)) {
+            earliest = entry->deadline;
+        }
+    }
+    if (pool->pending_head == NULL) {
+        pool->pending_tail = NULL;
+    }
+    pool->batch_leader = 0;
+    pthread_cond_broadcast(&pool->batch_done);
+    if (count == 0) {
+        return;
+    }
+
+    size_t response_size = 0;
+    char *request = pool_batch_request(batch, count, &response_size);
+    char *response = request != NULL ? malloc(response_size) : NULL;
+    int status = -1;
+    if (response != NULL) {
+        pthread_mutex_unlock(&pool->lock);
+        status = pool_exchange(pool, request, response, response_size, &earliest);
+        pthread_mutex_lock(&pool->lock);
+    }
+
+    if (status == 0 && count == 1) {
+        pool_deliver(batch[0], response, strlen(response));
+    } else if (status == 0) {
+        pool_split_batch(response, batch, count);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (batch[i] != NULL) {
+            batch[i]->claim = NULL;
+            batch[i]->done = 1;
+        }
+    }
+    pthread_cond_broadcast(&pool->batch_done);
+    free(request);
+    free(response);
+}
+
+static char *pool_batch_request(LlmPending **batch, size_t count, size_t *response_size) {
+    if (count == 1) {
+        size_t length = strlen(batch[0]->request);
+        char *request = malloc(length + 1);
+        if (request != NULL) {
+            memcpy(request, batch[0]->request, length + 1);
+        }
+        *response_size = batch[0]->response_size;
+        return request;
+    }
+
+    size_t request_length = 2;
+    *response_size = 2;
+    for (size_t i = 0; i < count; ++i) {
+        request_length += strlen(batch[i]->request) + 1;
+        *response_size += batch[i]->response_size + 1;
+    }
+    char *request = malloc(request_length + 1);
+    if (request == NULL) {
+        return NULL;
+    }
+
+    size_t offset = 0;
+    request[offset++] = '[';
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            request[offset++] = ',';
+        }
+        size_t length = strlen(batch[i]->request);
+        memcpy(request + offset, batch[i]->request, length);
+        offset += length;
+    }
+    request[offset++] = ']';
+    request[offset] = '\0';
+    return request;
+}
+
+static void pool_deliver(LlmPending *pending, const char *response, size_t length) {
+    if (pending == NULL || length == 0 || length >= pending->response_size) {
+        return;
+    }
+    memcpy(pending->response, response, length);
+    pending->response[length] = '\0';
+    pending->status = 0;
+}
+
+static void pool_split_batch(const char *response, LlmPending **batch, size_t count) {
+    const char *starts[AMS_LLM_POOL_MAX_BATCH];
+    size_t lengths[AMS_LLM_POOL_MAX_BATCH];
+    const char *cursor = response + strspn(response, " \t\r");
+    if (*cursor != '[') {
+        return;
+    }
+    ++cursor;
+
+    for (size_t i = 0; i < count; ++i) {
+        cursor += strspn(cursor, " \t\r");
+        starts[i] = cursor;
+        int depth = 0;
+        int in_string = 0;
+        for (; *cursor != '\0'; ++cursor) {
+            char c = *cursor;
+            if (in_string) {
+                if (c == '\\' && cursor[1] != '\0') {
+                    ++cursor;
+                } else if (c == '"') {
+                    in_string = 0;
+                }
+            } else if (c == '"') {
+                in_string = 1;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (depth > 0 && (c == '}' || c == ']')) {
+                --depth;
+            } else if (depth == 0 && (c == ',' || c == ']')) {
+                break;
+            }
+        }
+        if (*cursor != (i + 1 < count ? ',' : ']')) {
+            return;
+        }
+        size_t length = (size_t)(cursor - starts[i]);
+        while (length > 0 && (starts[i][length - 1] == ' ' || starts[i][length - 1] == '\t')) {
+            --length;
+        }
+        lengths[i] = length;
+        ++cursor;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        pool_deliver(batch[i], starts[i], lengths[i]);
+    }
+}
+
+static void pool_unlink_pending(LlmPool *pool, LlmPending *pending) {
+    LlmPending *previous = NULL;
+    for (LlmPending *entry = pool->pending_head; entry != NULL; previous = entry, entry = entry->next) {
+        if (entry != pending) {
+            continue;
+        }
+        if (previous != NULL) {
+            previous->next = entry->next;
+        } else {
+            pool->pending_head = entry->next;
+        }
+        if (pool->pending_tail == entry) {
+            pool->pending_tail = previous;
+        }
+        --pool->pending_count;
+        return;
+    }
+}
+
+static int pool_exchange(
+    LlmPool *pool,
+    const char *request,
+    char *response,
+    size_t response_size,
+    const struct timespec *deadline) {
+    LlmWorker *worker = pool_acquire(pool, deadline);
+    if (worker == NULL) {
+        return -1;
+    }
+
+    int status = -1;
+    if (worker->pid > 0 || worker_spawn(worker, pool->command) == 0) {
+        status = worker_write(worker, request, strlen(request), deadline);
+        if (status == 0) {
+            status = worker_write(worker, "\n", 1, deadline);
+        }
+        if (status == 0) {
+            status = worker_read_line(worker, response, response_size, deadline);
+        }
+        if (status != 0) {
+            worker_stop(worker);
+        }
+    }
+    if (status != 0) {
+        response[0] = '\0';
+    }
+    pool_release(pool, worker);
+    return status;
+}
+
+static LlmWorker *pool_acquire(LlmPool *pool, const struct timespec *deadline) {
+    LlmWorker *worker = NULL;
+    pthread_mutex_lock(&pool->lock);
+    while (pool->running) {
+        for (size_t i = 0; i < pool->worker_count; ++i) {
+            LlmWorker *candidate = &pool->workers[i];
+            if (candidate->busy) {
+                continue;
+            }
+            if (worker == NULL || (worker->pid <= 0 && candidate->pid > 0)) {
+                worker = candidate;
+            }
+        }
+        if (worker != NULL) {
+            worker->busy = 1;
+            break;
+        }
+        if (pthread_cond_timedwait(&pool->available, &pool->lock, deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return worker;
+}
+
+static void pool_release(LlmPool *pool, LlmWorker *worker) {
+    pthread_mutex_lock(&pool->lock);
+    worker->busy = 0;
+    pthread_cond_broadcast(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static int worker_spawn(LlmWorker *worker, const char *command) {
+    int request_pipe[2];
+    int response_pipe[2];
+    if (pipe2(request_pipe, O_CLOEXEC) != 0) {
+        return -1;
+    }
+    if (pipe2(response_pipe, O_CLOEXEC) != 0) {
+        close(request_pipe[0]);
+        close(request_pipe[1]);
+        return -1;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(request_pipe[0]);
+        close(request_pipe[1]);
+        close(response_pipe[0]);
+        close(response_pipe[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        setpgid(0, 0);
+        dup2(request_pipe[0], STDIN_FILENO);
+        dup2(response_pipe[1], STDOUT_FILENO);
+        close(request_pipe[0]);
+        close(response_pipe[1]);
+        execl("/bin/sh", "sh", "-c", command, (char *)NULL);
+        _exit(127);
+    }
+
+    close(request_pipe[0]);
+    close(response_pipe[1]);
+    worker->pid = pid;
+    worker->request_fd = request_pipe[1];
+    worker->response_fd = response_pipe[0];
+    return 0;
+}
+
+static void worker_stop(LlmWorker *worker) {
+    if (worker->request_fd >= 0) {
+        close(worker->request_fd);
+    }
+    if (worker->response_fd >= 0) {
+        close(worker->response_fd);
+    }
+    if (worker->pid > 0) {
+        kill(-worker->pid, SIGKILL);
+        kill(worker->pid, SIGKILL);
+        while (waitpid(worker->pid, NULL, 0) < 0 && errno == EINTR) {
+        }
+    }
+    worker->pid = -1;
+    worker->request_fd = -1;
+    worker->response_fd = -1;
+}
+
+static int worker_write(LlmWorker *worker, const char *data, size_t length, const struct timespec *deadline) {
+    size_t offset = 0;
+    while (offset < length) {
+        int wait_ms = remaining_ms(deadline);
+        if (wait_ms <= 0) {
+            return -1;
+        }
+        struct pollfd descriptor = {worker->request_fd, POLLOUT, 0};
+        int ready = poll(&descriptor, 1, wait_ms);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0 || (descriptor.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
+            return -1;
+        }
+        ssize_t count = write(worker->request_fd, data + offset, length - offset);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        offset += (size_t)count;
+    }
+    return 0;
+}
+
+static int worker_read_line(LlmWorker *worker, char *response, size_t response_size, const struct timespec *deadline) {
+    size_t length = 0;
+    for (;;) {
+        int wait_ms = remaining_ms(deadline);
+        if (wait_ms <= 0 || length + 1 >= response_size) {
+            return -1;
+        }
+        struct pollfd descriptor = {worker->response_fd, POLLIN, 0};
+        int ready = poll(&descriptor, 1, wait_ms);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            return -1;
+        }
+        ssize_t count = read(worker->response_fd, response + length, response_size - 1 - length);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (count == 0) {
+            return -1;
+        }
+        char *newline = memchr(response + length, '\n', (size_t)count);
+        length += (size_t)count;
+        response[length] = '\0';
+        if (newline != NULL) {
+            if ((size_t)(newline - response) + 1 != length) {
+                return -1;
+            }
+            *newline = '\0';
+            return 0;
+        }
+    }
+}
+
+static int remaining_ms(const struct timespec *deadline) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long remaining = (long long)(deadline->tv_sec - now.tv_sec) * 1000LL +
+                          (deadline->tv_nsec - now.tv_nsec) / 1000000L;
+    if (remaining <= 0) {
+        return 0;
+    }
+    return remaining > 60000 ? 60000 : (int)remaining;
+}
+
+static int deadline_before(const struct timespec *left, const struct timespec *right) {
+    return left->tv_sec < right->tv_sec || (left->tv_sec == right->tv_sec && left->tv_nsec < right->tv_nsec);
+}
+
+static void deadline_after(struct timespec *deadline, int milliseconds) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += milliseconds / 1000;
+    deadline->tv_nsec += (long)(milliseconds % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec += 1;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
@@ -0,0 +1,688 @@
+#include "location_index.h"
+#include "edit_distance.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define AMS_FNV_OFFSET 1469598103934665603ULL
+#define AMS_FNV_PRIME 1099511628211ULL
+#define AMS_TRIGRAM_MAX_GRAMS 256
+#define AMS_BK_NONE UINT32_MAX
+
+typedef struct {
+    uint64_t fingerprint;
+    uint32_t record;
+} KeyIndexEntry;
+
+static int dictionary_grow_slots(StringDictionary *dictionary);
+static int dictionary_reserve_entries(StringDictionary *dictionary, size_t required);
+static int dictionary_reserve_arena(StringDictionary *dictionary, size_t required);
+static int compare_key_entries(const void *lhs, const void *rhs);
+static int compare_ids(const void *lhs, const void *rhs);
+static int append_id(uint32_t **ids, size_t *count, size_t *capacity, uint32_t id);
+static size_t trigram_fingerprints(const char *value, uint64_t *fingerprints, size_t max_grams);
+
+uint64_t ams_hash_bytes(uint64_t seed, const void *data, size_t length) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    uint64_t hash = seed ? seed : AMS_FNV_OFFSET;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (uint64_t)bytes[i];
+        hash *= AMS_FNV_PRIME;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+uint64_t ams_hash_string(const char *value) {
+    if (value == NULL) {
+        return ams_hash_bytes(0, "", 0);
+    }
+    return ams_hash_bytes(0, value, strlen(value));
+}
+
+uint64_t ams_fingerprint(const char *value) {
+    if (value == NULL || value[0] == '\0') {
+        return 0;
+    }
+    uint64_t hash = ams_hash_string(value);
+    return hash != 0 ? hash : 1;
+}
+
+void string_dictionary_init(StringDictionary *dictionary) {
+    if (dictionary == NULL) {
+        return;
+    }
+    memset(dictionary, 0, sizeof(*dictionary));
+}
+
+void string_dictionary_free(StringDictionary *dictionary) {
+    if (dictionary == NULL) {
+        return;
+    }
+    free(dictionary->arena);
+    free(dictionary->offsets);
+    free(dictionary->hashes);
+    free(dictionary->slots);
+    memset(dictionary, 0, sizeof(*dictionary));
+}
+
+int string_dictionary_intern(StringDictionary *dictionary, const char *value, uint32_t *id_out) {
+    if (dictionary == NULL || value == NULL) {
+        return -1;
+    }
+
+    uint32_t existing = string_dictionary_find(dictionary, value);
+    if (existing != AMS_DICTIONARY_NONE) {
+        if (id_out) {
+            *id_out = existing;
+        }
+        return 0;
+    }
+
+    if (dictionary->count >= AMS_DICTIONARY_NONE - 1) {
+        return -1;
+    }
+    if ((dictionary->count + 1) * 2 > dictionary->slot_count && dictionary_grow_slots(dictionary) != 0) {
+        return -1;
+    }
+
+    size_t length = strlen(value);
+    if (dictionary_reserve_entries(dictionary, dictionary->count + 1) != 0 ||
+        dictionary_reserve_arena(dictionary, dictionary->arena_length + length + 1) != 0) {
+        return -1;
+    }
+
+    uint32_t id = (uint32_t)dictionary->count;
+    uint64_t hash = ams_hash_bytes(0, value, length);
+    memcpy(dictionary->arena + dictionary->arena_length, value, length + 1);
+    dictionary->offsets[id] = (uint32_t)dictionary->arena_length;
+    dictionary->hashes[id] = hash;
+    dictionary->arena_length += length + 1;
+    dictionary->count++;
+
+    size_t mask = dictionary->slot_count - 1;
+    size_t slot = (size_t)hash & mask;
+    while (dictionary->slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    dictionary->slots[slot] = id + 1;
+
+    if (id_out) {
+        *id_out = id;
+    }
+    return 0;
+}
+
+uint32_t string_dictionary_find(const StringDictionary *dictionary, const char *value) {
+    if (value == NULL) {
+        return AMS_DICTIONARY_NONE;
+    }
+    return string_dictionary_find_length(dictionary, value, strlen(value));
+}
+
+uint32_t string_dictionary_find_length(const StringDictionary *dictionary, const char *value, size_t length) {
+    if (dictionary == NULL || value == NULL || dictionary->slot_count == 0) {
+        return AMS_DICTIONARY_NONE;
+    }
+    uint64_t hash = ams_hash_bytes(0, value, length);
+    size_t mask = dictionary->slot_count - 1;
+    size_t slot = (size_t)hash & mask;
+    while (dictionary->slots[slot] != 0) {
+        uint32_t id = dictionary->slots[slot] - 1;
+        const char *candidate = dictionary->arena + dictionary->offsets[id];
+        if (dictionary->hashes[id] == hash && strncmp(candidate, value, length) == 0 &&
+            candidate[length] == '\0') {
+            return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return AMS_DICTIONARY_NONE;
+}
+
+const char *string_dictionary_get(const StringDictionary *dictionary, uint32_t id) {
+    if (dictionary == NULL || id >= dictionary->count) {
+        return "";
+    }
+    return dictionary->arena + dictionary->offsets[id];
+}
+
+void key_index_init(KeyIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+    memset(index, 0, sizeof(*index));
+}
+
+void key_index_free(KeyIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+    free(index->slots);
+    free(index->postings);
+    memset(index, 0, sizeof(*index));
+}
+
+int key_index_build(KeyIndex *index, const uint64_t *fingerprints, size_t count) {
+    return key_index_build_pairs(index, fingerprints, NULL, count);
+}
+
+int key_index_build_pairs(KeyIndex *index, const uint64_t *fingerprints, const uint32_t *values, size_t count) {
+    if (index == NULL || (fingerprints == NULL && count > 0) || count >= UINT32_MAX) {
+        return -1;
+    }
+    key_index_free(index);
+
+    size_t keyed = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (fingerprints[i] != 0) {
+            ++keyed;
+        }
+    }
+    if (keyed == 0) {
+        return 0;
+    }
+
+    KeyIndexEntry *entries = malloc(keyed * sizeof(KeyIndexEntry));
+    uint32_t *postings = malloc(keyed * sizeof(uint32_t));
+    if (entries == NULL || postings == NULL) {
+        free(entries);
+        free(postings);
+        return -1;
+    }
+
+    size_t write_index = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (fingerprints[i] != 0) {
+            entries[write_index].fingerprint = fingerprints[i];
+            entries[write_index].record = values ? values[i] : (uint32_t)i;
+            ++write_index;
+        }
+    }
+    qsort(entries, keyed, sizeof(KeyIndexEntry), compare_key_entries);
+
+    size_t distinct = 0;
+    for (size_t i = 0; i < keyed; ++i) {
+        postings[i] = entries[i].record;
+        if (i == 0 || entries[i].fingerprint != entries[i - 1].fingerprint) {
+            ++distinct;
+        }
+    }
+
+    size_t slot_count = 16;
+    while (slot_count < distinct * 2) {
+        slot_count *= 2;
+    }
+    KeyIndexSlot *slots = calloc(slot_count, sizeof(KeyIndexSlot));
+    if (slots == NULL) {
+        free(entries);
+        free(postings);
+        return -1;
+    }
+
+    size_t mask = slot_count - 1;
+    size_t run_start = 0;
+    for (size_t i = 1; i <= keyed; ++i) {
+        if (i < keyed && entries[i].fingerprint == entries[run_start].fingerprint) {
+            continue;
+        }
+        uint64_t fingerprint = entries[run_start].fingerprint;
+        size_t slot = (size_t)fingerprint & mask;
+        while (slots[slot].fingerprint != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot].fingerprint = fingerprint;
+        slots[slot].start = (uint32_t)run_start;
+        slots[slot].length = (uint32_t)(i - run_start);
+        run_start = i;
+    }
+
+    free(entries);
+    index->slots = slots;
+    index->slot_count = slot_count;
+    index->postings = postings;
+    index->posting_count = keyed;
+    return 0;
+}
+
+const uint32_t *key_index_lookup(const KeyIndex *index, uint64_t fingerprint, size_t *count) {
+    if (count) {
+        *count = 0;
+    }
+    if (index == NULL || index->slot_count == 0 || fingerprint == 0) {
+        return NULL;
+    }
+    size_t mask = index->slot_count - 1;
+    size_t slot = (size_t)fingerprint & mask;
+    while (index->slots[slot].fingerprint != 0) {
+        if (index->slots[slot].fingerprint == fingerprint) {
+            if (count) {
+                *count = index->slots[slot].length;
+            }
+            return index->postings + index->slots[slot].start;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+void trigram_index_init(TrigramIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+    key_index_init(&index->grams);
+    index->gram_counts = NULL;
+    index->name_count = 0;
+}
+
+void trigram_index_free(TrigramIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+    key_index_free(&index->grams);
+    free(index->gram_counts);
+    index->gram_counts = NULL;
+    index->name_count = 0;
+}
+
+int trigram_index_build(TrigramIndex *index, const StringDictionary *names) {
+    if (index == NULL || names == NULL) {
+        return -1;
+    }
+    trigram_index_free(index);
+    if (names->count == 0) {
+        return 0;
+    }
+
+    uint16_t *gram_counts = malloc(names->count * sizeof(uint16_t));
+    if (gram_counts == NULL) {
+        return -1;
+    }
+
+    size_t total = 0;
+    uint64_t grams[AMS_TRIGRAM_MAX_GRAMS];
+    for (size_t id = 0; id < names->count; ++id) {
+        size_t count = trigram_fingerprints(string_dictionary_get(names, (uint32_t)id), grams, AMS_TRIGRAM_MAX_GRAMS);
+        gram_counts[id] = (uint16_t)count;
+        total += count;
+    }
+
+    uint64_t *fingerprints = malloc((total > 0 ? total : 1) * sizeof(uint64_t));
+    uint32_t *values = malloc((total > 0 ? total : 1) * sizeof(uint32_t));
+    if (fingerprints == NULL || values == NULL) {
+        free(fingerprints);
+        free(values);
+        free(gram_counts);
+        return -1;
+    }
+
+    size_t offset = 0;
+    for (size_t id = 0; id < names->count; ++id) {
+        size_t count = trigram_fingerprints(
+            string_dictionary_get(names, (uint32_t)id),
+            fingerprints + offset,
+            AMS_TRIGRAM_MAX_GRAMS);
+        for (size_t i = 0; i < count; ++i) {
+            values[offset + i] = (uint32_t)id;
+        }
+        offset += count;
+    }
+
+    int status = key_index_build_pairs(&index->grams, fingerprints, values, total);
+    free(fingerprints);
+    free(values);
+    if (status != 0) {
+        free(gram_counts);
+        return -1;
+    }
+    index->gram_counts = gram_counts;
+    index->name_count = names->count;
+    return 0;
+}
+
+int trigram_index_search(
+    const TrigramIndex *index,
+    const StringDictionary *names,
+    const char *query,
+    double min_similarity,
+    uint32_t **ids_out,
+    size_t *count_out) {
+    if (ids_out == NULL || count_out == NULL) {
+        return -1;
+    }
+    *ids_out = NULL;
+    *count_out = 0;
+    if (index == NULL || names == NULL || query == NULL || query[0] == '\0' || index->name_count == 0) {
+        return 0;
+    }
+
+    size_t query_length = strlen(query);
+    uint64_t grams[AMS_TRIGRAM_MAX_GRAMS];
+    size_t query_count = trigram_fingerprints(query, grams, AMS_TRIGRAM_MAX_GRAMS);
+    if (query_count == 0) {
+        return 0;
+    }
+
+    uint16_t *shared = calloc(index->name_count, sizeof(uint16_t));
+    size_t touched_capacity = 256;
+    size_t touched_count = 0;
+    uint32_t *touched = malloc(touched_capacity * sizeof(uint32_t));
+    if (shared == NULL || touched == NULL) {
+        free(shared);
+        free(touched);
+        return -1;
+    }
+
+    for (size_t g = 0; g < query_count; ++g) {
+        size_t posting_count = 0;
+        const uint32_t *postings = key_index_lookup(&index->grams, grams[g], &posting_count);
+        for (size_t i = 0; i < posting_count; ++i) {
+            uint32_t id = postings[i];
+            if (shared[id]++ != 0) {
+                continue;
+            }
+            if (touched_count == touched_capacity) {
+                uint32_t *grown = realloc(touched, touched_capacity * 2 * sizeof(uint32_t));
+                if (grown == NULL) {
+                    free(shared);
+                    free(touched);
+                    return -1;
+                }
+                touched = grown;
+                touched_capacity *= 2;
+            }
+            touched[touched_count++] = id;
+        }
+    }
+
+    size_t match_count = 0;
+    for (size_t i = 0; i < touched_count; ++i) {
+        uint32_t id = touched[i];
+        const char *name = string_dictionary_get(names, id);
+        size_t name_length = strlen(name);
+        size_t max_length = query_length > name_length ? query_length : name_length;
+        int max_distance = (int)((1.0 - min_similarity) * (double)max_length + 1e-9);
+        size_t name_count = index->gram_counts[id];
+        size_t larger_count = query_count > name_count ? query_count : name_count;
+        if (larger_count < AMS_TRIGRAM_MAX_GRAMS &&
+            (long)shared[id] < (long)larger_count - 3L * (long)max_distance) {
+            continue;
+        }
+        if (edit_distance_bounded(query, query_length, name, name_length, max_distance) <= max_distance) {
+            touched[match_count++] = id;
+        }
+    }
+    free(shared);
+
+    if (match_count == 0) {
+        free(touched);
+        return 0;
+    }
+    qsort(touched, match_count, sizeof(uint32_t), compare_ids);
+    *ids_out = touched;
+    *count_out = match_count;
+    return 0;
+}
+
+void bk_tree_init(BkTree *tree) {
+    if (tree == NULL) {
+        return;
+    }
+    tree->nodes = NULL;
+    tree->node_count = 0;
+}
+
+void bk_tree_free(BkTree *tree) {
+    if (tree == NULL) {
+        return;
+    }
+    free(tree->nodes);
+    tree->nodes = NULL;
+    tree->node_count = 0;
+}
+
+int bk_tree_build(BkTree *tree, const StringDictionary *names) {
+    if (tree == NULL || names == NULL) {
+        return -1;
+    }
+    bk_tree_free(tree);
+    if (names->count == 0) {
+        return 0;
+    }
+
+    BkTreeNode *nodes = malloc(names->count * sizeof(BkTreeNode));
+    if (nodes == NULL) {
+        return -1;
+    }
+
+    size_t node_count = 0;
+    for (size_t id = 0; id < names->count; ++id) {
+        const char *name = string_dictionary_get(names, (uint32_t)id);
+        size_t name_length = strlen(name);
+        if (name_length == 0) {
+            continue;
+        }
+
+        BkTreeNode *node = &nodes[node_count];
+        node->name_id = (uint32_t)id;
+        node->distance = 0;
+        node->first_child = AMS_BK_NONE;
+        node->next_sibling = AMS_BK_NONE;
+        if (node_count == 0) {
+            ++node_count;
+            continue;
+        }
+
+        uint32_t current = 0;
+        for (;;) {
+            const char *current_name = string_dictionary_get(names, nodes[current].name_id);
+            uint32_t distance = (uint32_t)edit_distance(name, name_length, current_name, strlen(current_name));
+            uint32_t child = nodes[current].first_child;
+            while (child != AMS_BK_NONE && nodes[child].distance != distance) {
+                child = nodes[child].next_sibling;
+            }
+            if (child == AMS_BK_NONE) {
+                node->distance = distance;
+                node->next_sibling = nodes[current].first_child;
+                nodes[current].first_child = (uint32_t)node_count;
+                break;
+            }
+            current = child;
+        }
+        ++node_count;
+    }
+
+    tree->nodes = nodes;
+    tree->node_count = node_count;
+    return 0;
+}
+
+int bk_tree_search(
+    const BkTree *tree,
+    const StringDictionary *names,
+    const char *query,
+    int max_distance,
+    uint32_t **ids_out,
+    size_t *count_out) {
+    if (ids_out == NULL || count_out == NULL) {
+        return -1;
+    }
+    *ids_out = NULL;
+    *count_out = 0;
+    if (tree == NULL || names == NULL || query == NULL || query[0] == '\0' ||
+        tree->node_count == 0 || max_distance < 0) {
+        return 0;
+    }
+
+    size_t query_length = strlen(query);
+    size_t stack_capacity = 64;
+    size_t stack_count = 0;
+    uint32_t *stack = malloc(stack_capacity * sizeof(uint32_t));
+    if (stack == NULL) {
+        return -1;
+    }
+    stack[stack_count++] = 0;
+
+    uint32_t *ids = NULL;
+    size_t id_count = 0;
+    size_t id_capacity = 0;
+    int status = 0;
+    while (stack_count > 0 && status == 0) {
+        const BkTreeNode *node = &tree->nodes[stack[--stack_count]];
+        const char *name = string_dictionary_get(names, node->name_id);
+        int distance = edit_distance(query, query_length, name, strlen(name));
+        if (distance <= max_distance) {
+            status = append_id(&ids, &id_count, &id_capacity, node->name_id);
+        }
+
+        uint32_t low = distance > max_distance ? (uint32_t)(distance - max_distance) : 0;
+        uint32_t high = (uint32_t)(distance + max_distance);
+        for (uint32_t child = node->first_child; child != AMS_BK_NONE && status == 0;
+             child = tree->nodes[child].next_sibling) {
+            if (tree->nodes[child].distance < low || tree->nodes[child].distance > high) {
+                continue;
+            }
+            status = append_id(&stack, &stack_count, &stack_capacity, child);
+        }
+    }
+    free(stack);
+
+    if (status != 0) {
+        free(ids);
+        return -1;
+    }
+    if (id_count > 1) {
+        qsort(ids, id_count, sizeof(uint32_t), compare_ids);
+    }
+    *ids_out = ids;
+    *count_out = id_count;
+    return 0;
+}
+
+static int append_id(uint32_t **ids, size_t *count, size_t *capacity, uint32_t id) {
+    if (*count == *capacity) {
+        size_t new_capacity = *capacity == 0 ? 64 : *capacity * 2;
+        uint32_t *grown = realloc(*ids, new_capacity * sizeof(uint32_t));
+        if (grown == NULL) {
+            return -1;
+        }
+        *ids = grown;
+        *capacity = new_capacity;
+    }
+    (*ids)[(*count)++] = id;
+    return 0;
+}
+
+static size_t trigram_fingerprints(const char *value, uint64_t *fingerprints, size_t max_grams) {
+    size_t length = strlen(value);
+    if (length == 0) {
+        return 0;
+    }
+
+    unsigned char padded[AMS_TRIGRAM_MAX_GRAMS + 3];
+    size_t padded_length = 0;
+    padded[padded_length++] = ' ';
+    padded[padded_length++] = ' ';
+    for (size_t i = 0; i < length && padded_length < sizeof(padded) - 1; ++i) {
+        padded[padded_length++] = (unsigned char)value[i];
+    }
+    padded[padded_length++] = ' ';
+
+    uint32_t grams[AMS_TRIGRAM_MAX_GRAMS];
+    size_t count = 0;
+    for (size_t i = 0; i + 2 < padded_length && count < max_grams; ++i) {
+        uint32_t gram = ((uint32_t)padded[i] << 16) | ((uint32_t)padded[i + 1] << 8) | (uint32_t)padded[i + 2];
+        uint32_t occurrence = 0;
+        for (size_t j = 0; j < count; ++j) {
+            if ((grams[j] & 0xFFFFFFU) == gram) {
+                ++occurrence;
+            }
+        }
+        grams[count] = gram | (occurrence << 24);
+        uint64_t fingerprint = ams_hash_bytes(0, &grams[count], sizeof(grams[count]));
+        fingerprints[count] = fingerprint != 0 ? fingerprint : 1;
+        ++count;
+    }
+    return count;
+}
+
+static int compare_ids(const void *lhs, const void *rhs) {
+    uint32_t left = *(const uint32_t *)lhs;
+    uint32_t right = *(const uint32_t *)rhs;
+    return (left > right) - (left < right);
+}
+
+static int compare_key_entries(const void *lhs, const void *rhs) {
+    const KeyIndexEntry *left = (const KeyIndexEntry *)lhs;
+    const KeyIndexEntry *right = (const KeyIndexEntry *)rhs;
+    if (left->fingerprint != right->fingerprint) {
+        return left->fingerprint < right->fingerprint ? -1 : 1;
+    }
+    if (left->record != right->record) {
+        return left->record < right->record ? -1 : 1;
+    }
+    return 0;
+}
+
+static int dictionary_grow_slots(StringDictionary *dictionary) {
+    size_t new_count = dictionary->slot_count == 0 ? 64 : dictionary->slot_count * 2;
+    uint32_t *slots = calloc(new_count, sizeof(uint32_t));
+    if (slots == NULL) {
+        return -1;
+    }
+    size_t mask = new_count - 1;
+    for (size_t id = 0; id < dictionary->count; ++id) {
+        size_t slot = (size_t)dictionary->hashes[id] & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = (uint32_t)id + 1;
+    }
+    free(dictionary->slots);
+    dictionary->slots = slots;
+    dictionary->slot_count = new_count;
+    return 0;
+}
+
+static int dictionary_reserve_entries(StringDictionary *dictionary, size_t required) {
+    if (dictionary->capacity >= required) {
+        return 0;
+    }
+    size_t new_capacity = dictionary->capacity == 0 ? 64 : dictionary->capacity * 2;
+    while (new_capacity < required) {
+        new_capacity *= 2;
+    }
+    uint32_t *offsets = realloc(dictionary->offsets, new_capacity * sizeof(uint32_t));
+    if (offsets == NULL) {
+        return -1;
+    }
+    dictionary->offsets = offsets;
+    uint64_t *hashes = realloc(dictionary->hashes, new_capacity * sizeof(uint64_t));
+    if (hashes == NULL) {
+        return -1;
+    }
+    dictionary->hashes = hashes;
+    dictionary->capacity = new_capacity;
+    return 0;
+}
+
+static int dictionary_reserve_arena(StringDictionary *dictionary, size_t required) {
+    if (dictionary->arena_capacity >= required) {
+        return 0;
+    }
+    if (required > UINT32_MAX) {
+        return -1;
+    }
+    size_t new_capacity = dictionary->arena_capacity == 0 ? 4096 : dictionary->arena_capacity * 2;
+    while (new_capacity < required) {
+        new_capacity *= 2;
+    }
+    char *arena = realloc(dictionary->arena, new_capacity);
+    if (arena == NULL) {
+        return -1;
+    }
+    dictionary->arena = arena;
+    dictionary->arena_capacity = new_capacity;
+    return 0;
+}
@@ -0,0 +1,371 @@
+#include "normalization_rules.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define AMS_RULES_LINE_LENGTH 1024
+#define AMS_RULES_MAX_KEYWORD_LENGTH 64
+
+static const char *rules_parse_line(NormalizationRules *rules, char *line);
+static const char *rules_set_version(NormalizationRules *rules, const char *value);
+static const char *rules_add_rewrite(NormalizationRules *rules, const char *from, const char *to);
+static const char *rules_add_keyword(
+    NormalizationRules *rules,
+    const char *text,
+    unsigned kind,
+    const char *canonical);
+static int rules_reserve_keywords(NormalizationRules *rules, size_t required);
+static int rules_reserve_rewrites(NormalizationRules *rules, size_t required);
+static int rules_finalize(NormalizationRules *rules);
+static size_t rules_normalize(const char *value, char *out, size_t out_size);
+static char *rules_trim(char *value);
+
+void normalization_rules_init(NormalizationRules *rules) {
+    if (rules == NULL) {
+        return;
+    }
+    memset(rules, 0, sizeof(*rules));
+    string_dictionary_init(&rules->keyword_texts);
+    string_dictionary_init(&rules->rewrite_needles);
+    string_dictionary_init(&rules->values);
+}
+
+void normalization_rules_free(NormalizationRules *rules) {
+    if (rules == NULL) {
+        return;
+    }
+    string_dictionary_free(&rules->keyword_texts);
+    string_dictionary_free(&rules->rewrite_needles);
+    string_dictionary_free(&rules->values);
+    free(rules->keywords);
+    free(rules->canonical_ids);
+    free(rules->rewrites);
+    free(rules->replacement_ids);
+    normalization_rules_init(rules);
+}
+
+int normalization_rules_load(NormalizationRules *rules, const char *path, char *error, size_t error_size) {
+    if (rules == NULL || path == NULL) {
+        return -1;
+    }
+    normalization_rules_free(rules);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        if (error != NULL) {
+            snprintf(error, error_size, "%s: %s", path, strerror(errno));
+        }
+        return -1;
+    }
+
+    char line[AMS_RULES_LINE_LENGTH];
+    size_t line_number = 0;
+    uint64_t content_hash = 0;
+    const char *message = NULL;
+    while (message == NULL && fgets(line, sizeof(line), file) != NULL) {
+        ++line_number;
+        size_t length = strlen(line);
+        if (length == sizeof(line) - 1 && line[length - 1] != '\n' && !feof(file)) {
+            message = "line too long";
+            break;
+        }
+        content_hash = ams_hash_bytes(content_hash, line, length);
+        message = rules_parse_line(rules, line);
+    }
+    if (message == NULL && ferror(file)) {
+        message = strerror(errno);
+    }
+    fclose(file);
+
+    if (message == NULL && rules->keyword_texts.count == 0 && rules->rewrite_needles.count == 0) {
+        message = "no rules defined";
+        line_number = 0;
+    }
+    if (message == NULL && rules_finalize(rules) != 0) {
+        message = "out of memory";
+        line_number = 0;
+    }
+    if (message != NULL) {
+        if (error != NULL && line_number > 0) {
+            snprintf(error, error_size, "%s:%zu: %s", path, line_number, message);
+        } else if (error != NULL) {
+            snprintf(error, error_size, "%s: %s", path, message);
+        }
+        normalization_rules_free(rules);
+        return -1;
+    }
+
+    if (rules->version[0] == '\0') {
+        snprintf(rules->version, sizeof(rules->version), "%016" PRIx64, content_hash);
+    }
+    return 0;
+}
+
+const ParserKeyword *normalization_rules_lookup(const NormalizationRules *rules, const char *text, size_t length) {
+    if (rules == NULL || text == NULL) {
+        return NULL;
+    }
+    uint32_t id = string_dictionary_find_length(&rules->keyword_texts, text, length);
+    if (id == AMS_DICTIONARY_NONE || id >= rules->keyword_count) {
+        return NULL;
+    }
+    return &rules->keywords[id];
+}
+
+static const char *rules_parse_line(NormalizationRules *rules, char *line) {
+    char *cursor = rules_trim(line);
+    if (*cursor == '\0' || *cursor == '#') {
+        return NULL;
+    }
+
+    char *directive = cursor;
+    while (*cursor != '\0' && !isspace((unsigned char)*cursor)) {
+        ++cursor;
+    }
+    if (*cursor != '\0') {
+        *cursor++ = '\0';
+    }
+    char *argument = rules_trim(cursor);
+
+    if (strcmp(directive, "version") == 0) {
+        return rules_set_version(rules, argument);
+    }
+
+    char *equals = strchr(argument, '=');
+    if (equals != NULL) {
+        *equals = '\0';
+    }
+    if (strcmp(directive, "rewrite") == 0) {
+        if (equals == NULL) {
+            return "rewrite expects FROM = TO";
+        }
+        return rules_add_rewrite(rules, argument, equals + 1);
+    }
+    if (strcmp(directive, "direction") == 0) {
+        const char *canonical = equals != NULL ? equals + 1 : argument;
+        return rules_add_keyword(rules, argument, AMS_KEYWORD_DIRECTION, canonical);
+    }
+    if (equals != NULL) {
+        return "unexpected '='";
+    }
+    if (strcmp(directive, "state") == 0) {
+        return rules_add_keyword(rules, argument, AMS_KEYWORD_STATE, NULL);
+    }
+    if (strcmp(directive, "suffix") == 0) {
+        return rules_add_keyword(rules, argument, AMS_KEYWORD_SUFFIX, NULL);
+    }
+    if (strcmp(directive, "unit") == 0) {
+        return rules_add_keyword(rules, argument, AMS_KEYWORD_UNIT, NULL);
+    }
+    return "unknown directive";
+}
+
+static const char *rules_set_version(NormalizationRules *rules, const char *value) {
+    if (rules->version[0] != '\0') {
+        return "version already set";
+    }
+    size_t length = strlen(value);
+    if (length == 0 || length >= sizeof(rules->version)) {
+        return "version must be 1-63 characters";
+    }
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = (unsigned char)value[i];
+        if (!isalnum(c) && c != '.' && c != '_' && c != '-' && c != ':' && c != '+') {
+            return "version may only contain letters, digits and . _ - : +";
+        }
+    }
+    memcpy(rules->version, value, length + 1);
+    return NULL;
+}
+
+static const char *rules_add_rewrite(NormalizationRules *rules, const char *from, const char *to) {
+    char source[AMS_REWRITE_MAX_NEEDLE + 1];
+    char target[AMS_RULES_LINE_LENGTH];
+    size_t source_length = rules_normalize(from, source, sizeof(source));
+    size_t target_length = rules_normalize(to, target, sizeof(target));
+    if (source_length == 0) {
+        return "rewrite source is empty";
+    }
+    if (source_length == SIZE_MAX || source_length + 2 > AMS_REWRITE_MAX_NEEDLE) {
+        return "rewrite source is too long";
+    }
+    if (target_length == SIZE_MAX) {
+        return "rewrite target is too long";
+    }
+
+    const char *boundary = source[source_length - 1] == '.' ? "" : " ";
+    char needle[AMS_REWRITE_MAX_NEEDLE + 3];
+    char replacement[AMS_RULES_LINE_LENGTH + 3];
+    snprintf(needle, sizeof(needle), " %s%s", source, boundary);
+    snprintf(replacement, sizeof(replacement), " %s%s", target, target_length > 0 ? boundary : "");
+
+    uint32_t id = string_dictionary_find(&rules->rewrite_needles, needle);
+    if (id != AMS_DICTIONARY_NONE) {
+        const char *existing = string_dictionary_get(&rules->values, rules->replacement_ids[id]);
+        return strcmp(existing, replacement) == 0 ? NULL : "conflicting rewrite for the same source";
+    }
+
+    uint32_t replacement_id = 0;
+    if (rules_reserve_rewrites(rules, rules->rewrite_needles.count + 1) != 0 ||
+        string_dictionary_intern(&rules->values, replacement, &replacement_id) != 0 ||
+        string_dictionary_intern(&rules->rewrite_needles, needle, &id) != 0) {
+        return "out of memory";
+    }
+    rules->replacement_ids[id] = replacement_id;
+    return NULL;
+}
+
+static const char *rules_add_keyword(
+    NormalizationRules *rules,
+    const char *text,
+    unsigned kind,
+    const char *canonical) {
+    char keyword[AMS_RULES_MAX_KEYWORD_LENGTH + 1];
+    size_t length = rules_normalize(text, keyword, sizeof(keyword));
+    if (length == 0) {
+        return "keyword is empty";
+    }
+    if (length == SIZE_MAX) {
+        return "keyword is too long";
+    }
+    if (strchr(keyword, ' ') != NULL || strchr(keyword, ',') != NULL) {
+        return "keyword must be a single word";
+    }
+    if (kind == AMS_KEYWORD_STATE && length != 2) {
+        return "state codes must be two characters";
+    }
+
+    char canonical_value[AMS_RULES_MAX_KEYWORD_LENGTH + 1];
+    uint32_t canonical_id = AMS_DICTIONARY_NONE;
+    if (canonical != NULL) {
+        size_t canonical_length = rules_normalize(canonical, canonical_value, sizeof(canonical_value));
+        if (canonical_length == 0 || canonical_length == SIZE_MAX || strchr(canonical_value, ' ') != NULL) {
+            return "canonical value must be a single word";
+        }
+        if (string_dictionary_intern(&rules->values, canonical_value, &canonical_id) != 0) {
+            return "out of memory";
+        }
+    }
+
+    uint32_t id = string_dictionary_find(&rules->keyword_texts, keyword);
+    if (id == AMS_DICTIONARY_NONE) {
+        if (rules_reserve_keywords(rules, rules->keyword_texts.count + 1) != 0 ||
+            string_dictionary_intern(&rules->keyword_texts, keyword, &id) != 0) {
+            return "out of memory";
+        }
+        rules->keywords[id].text = NULL;
+        rules->keywords[id].length = (unsigned char)length;
+        rules->keywords[id].kinds = 0;
+        rules->keywords[id].canonical = NULL;
+        rules->canonical_ids[id] = AMS_DICTIONARY_NONE;
+    }
+    if (canonical_id != AMS_DICTIONARY_NONE) {
+        if (rules->canonical_ids[id] != AMS_DICTIONARY_NONE && rules->canonical_ids[id] != canonical_id) {
+            return "conflicting canonical value for the same keyword";
+        }
+        rules->canonical_ids[id] = canonical_id;
+    }
+    rules->keywords[id].kinds |= (unsigned char)kind;
+    return NULL;
+}
+
+static int rules_reserve_keywords(NormalizationRules *rules, size_t required) {
+    if (required <= rules->keyword_capacity) {
+        return 0;
+    }
+    size_t capacity = rules->keyword_capacity == 0 ? 64 : rules->keyword_capacity * 2;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    ParserKeyword *keywords = realloc(rules->keywords, capacity * sizeof(ParserKeyword));
+    if (keywords == NULL) {
+        return -1;
+    }
+    rules->keywords = keywords;
+    uint32_t *canonical_ids = realloc(rules->canonical_ids, capacity * sizeof(uint32_t));
+    if (canonical_ids == NULL) {
+        return -1;
+    }
+    rules->canonical_ids = canonical_ids;
+    rules->keyword_capacity = capacity;
+    return 0;
+}
+
+static int rules_reserve_rewrites(NormalizationRules *rules, size_t required) {
+    if (required <= rules->rewrite_capacity) {
+        return 0;
+    }
+    size_t capacity = rules->rewrite_capacity == 0 ? 64 : rules->rewrite_capacity * 2;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    uint32_t *replacement_ids = realloc(rules->replacement_ids, capacity * sizeof(uint32_t));
+    if (replacement_ids == NULL) {
+        return -1;
+    }
+    rules->replacement_ids = replacement_ids;
+    rules->rewrite_capacity = capacity;
+    return 0;
+}
+
+static int rules_finalize(NormalizationRules *rules) {
+    rules->keyword_count = rules->keyword_texts.count;
+    for (size_t i = 0; i < rules->keyword_count; ++i) {
+        ParserKeyword *keyword = &rules->keywords[i];
+        keyword->text = string_dictionary_get(&rules->keyword_texts, (uint32_t)i);
+        keyword->canonical = rules->canonical_ids[i] != AMS_DICTIONARY_NONE
+                                 ? string_dictionary_get(&rules->values, rules->canonical_ids[i])
+                                 : keyword->text;
+    }
+
+    rules->rewrite_count = rules->rewrite_needles.count;
+    if (rules->rewrite_count == 0) {
+        return 0;
+    }
+    rules->rewrites = malloc(rules->rewrite_count * sizeof(RewriteRule));
+    if (rules->rewrites == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < rules->rewrite_count; ++i) {
+        rules->rewrites[i].needle = string_dictionary_get(&rules->rewrite_needles, (uint32_t)i);
+        rules->rewrites[i].replacement = string_dictionary_get(&rules->values, rules->replacement_ids[i]);
+    }
+    return 0;
+}
+
+static size_t rules_normalize(const char *value, char *out, size_t out_size) {
+    size_t length = 0;
+    int pending_space = 0;
+    for (const char *cursor = value; *cursor != '\0'; ++cursor) {
+        unsigned char c = (unsigned char)*cursor;
+        if (isspace(c)) {
+            pending_space = length > 0;
+            continue;
+        }
+        if (length + (size_t)pending_space + 1 >= out_size) {
+            return SIZE_MAX;
+        }
+        if (pending_space) {
+            out[length++] = ' ';
+            pending_space = 0;
+        }
+        out[length++] = (char)toupper(c);
+    }
+    out[length] = '\0';
+    return length;
+}
+
+static char *rules_trim(char *value) {
+    while (isspace((unsigned char)*value)) {
+        ++value;
+    }
+    size_t length = strlen(value);
+    while (length > 0 && isspace((unsigned char)value[length - 1])) {
+        value[--length] = '\0';
+    }
+    return value;
+}
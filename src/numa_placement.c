@@ -0,0 +1,214 @@
+#define _GNU_SOURCE
+#include "numa_placement.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define AMS_NUMA_SYSFS_ROOT "/sys/devices/system/node"
+#define AMS_PLACEMENT_ALIGNMENT 64
+#define AMS_DEFAULT_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+
+static int read_cpu_list(const char *path, uint64_t *mask);
+static int parse_cpu_list(const char *text, uint64_t *mask);
+static size_t huge_page_size(void);
+static size_t round_up(size_t value, size_t multiple);
+
+void numa_topology_load(NumaTopology *topology) {
+    if (topology == NULL) {
+        return;
+    }
+    memset(topology, 0, sizeof(*topology));
+
+    uint64_t online[AMS_NUMA_MAX_CPUS / 64];
+    if (read_cpu_list(AMS_NUMA_SYSFS_ROOT "/online", online) == 0) {
+        for (int node = 0; node < AMS_NUMA_MAX_CPUS && topology->node_count < AMS_NUMA_MAX_NODES; ++node) {
+            if ((online[node / 64] & (1ULL << (node % 64))) == 0) {
+                continue;
+            }
+            char path[128];
+            snprintf(path, sizeof(path), AMS_NUMA_SYSFS_ROOT "/node%d/cpulist", node);
+            uint64_t *cpus = topology->cpus[topology->node_count];
+            if (read_cpu_list(path, cpus) != 0) {
+                continue;
+            }
+            int has_cpus = 0;
+            for (size_t i = 0; i < AMS_NUMA_MAX_CPUS / 64; ++i) {
+                has_cpus |= cpus[i] != 0;
+            }
+            if (has_cpus) {
+                topology->node_ids[topology->node_count++] = node;
+            }
+        }
+    }
+
+    if (topology->node_count == 0) {
+        topology->node_ids[0] = 0;
+        topology->node_count = 1;
+    }
+}
+
+int numa_topology_bind(const NumaTopology *topology, size_t node) {
+    if (topology == NULL || node >= topology->node_count) {
+        return -1;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    size_t cpu_count = 0;
+    for (size_t cpu = 0; cpu < AMS_NUMA_MAX_CPUS && cpu < CPU_SETSIZE; ++cpu) {
+        if (topology->cpus[node][cpu / 64] & (1ULL << (cpu % 64))) {
+            CPU_SET(cpu, &set);
+            ++cpu_count;
+        }
+    }
+    if (cpu_count == 0) {
+        return 0;
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 ? 0 : -1;
+}
+
+void placement_arena_init(PlacementArena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+    memset(arena, 0, sizeof(*arena));
+}
+
+int placement_arena_map(PlacementArena *arena, size_t size, int huge_pages) {
+    if (arena == NULL) {
+        return -1;
+    }
+    placement_arena_init(arena);
+
+    size_t huge_size = huge_page_size();
+    size = round_up(size > 0 ? size : 1, huge_size);
+    void *base = MAP_FAILED;
+    if (huge_pages) {
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+        if (base != MAP_FAILED) {
+            arena->pages = PLACEMENT_PAGES_HUGETLB;
+        }
+    }
+
+    if (base == MAP_FAILED) {
+        size_t reserved = size + huge_size;
+        unsigned char *raw = mmap(NULL, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            return -1;
+        }
+        unsigned char *aligned = (unsigned char *)round_up((size_t)raw, huge_size);
+        if (aligned > raw) {
+            munmap(raw, (size_t)(aligned - raw));
+        }
+        if (raw + reserved > aligned + size) {
+            munmap(aligned + size, (size_t)(raw + reserved - (aligned + size)));
+        }
+        base = aligned;
+
+        if (huge_pages && madvise(base, size, MADV_HUGEPAGE) == 0) {
+            arena->pages = PLACEMENT_PAGES_TRANSPARENT;
+        }
+        long page_size = sysconf(_SC_PAGESIZE);
+        size_t stride = page_size > 0 ? (size_t)page_size : 4096;
+        for (size_t offset = 0; offset < size; offset += stride) {
+            ((volatile unsigned char *)base)[offset] = 0;
+        }
+    }
+
+    arena->base = base;
+    arena->size = size;
+    return 0;
+}
+
+void *placement_arena_copy(PlacementArena *arena, const void *data, size_t size) {
+    if (arena == NULL || data == NULL || size == 0) {
+        return NULL;
+    }
+    size_t offset = round_up(arena->used, AMS_PLACEMENT_ALIGNMENT);
+    if (arena->base == NULL) {
+        arena->used = offset + size;
+        return NULL;
+    }
+    if (offset > arena->size || size > arena->size - offset) {
+        return NULL;
+    }
+    memcpy(arena->base + offset, data, size);
+    arena->used = offset + size;
+    return arena->base + offset;
+}
+
+void placement_arena_release(PlacementArena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+    if (arena->base != NULL) {
+        munmap(arena->base, arena->size);
+    }
+    placement_arena_init(arena);
+}
+
+static int read_cpu_list(const char *path, uint64_t *mask) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    char line[4096];
+    int status = fgets(line, sizeof(line), file) != NULL ? parse_cpu_list(line, mask) : -1;
+    fclose(file);
+    return status;
+}
+
+static int parse_cpu_list(const char *text, uint64_t *mask) {
+    memset(mask, 0, AMS_NUMA_MAX_CPUS / 8);
+    const char *cursor = text;
+    while (*cursor != '\0' && *cursor != '\n') {
+        char *end = NULL;
+        long first = strtol(cursor, &end, 10);
+        if (end == cursor || first < 0) {
+            return -1;
+        }
+        long last = first;
+        cursor = end;
+        if (*cursor == '-') {
+            last = strtol(cursor + 1, &end, 10);
+            if (end == cursor + 1 || last < first) {
+                return -1;
+            }
+            cursor = end;
+        }
+        for (long cpu = first; cpu <= last && cpu < AMS_NUMA_MAX_CPUS; ++cpu) {
+            mask[cpu / 64] |= 1ULL << (cpu % 64);
+        }
+        if (*cursor == ',') {
+            ++cursor;
+        } else if (*cursor != '\0' && *cursor != '\n') {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static size_t huge_page_size(void) {
+    FILE *file = fopen("/proc/meminfo", "r");
+    if (file == NULL) {
+        return AMS_DEFAULT_HUGE_PAGE_SIZE;
+    }
+    char line[256];
+    size_t size_kb = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (sscanf(line, "Hugepagesize: %zu kB", &size_kb) == 1) {
+            break;
+        }
+    }
+    fclose(file);
+    return size_kb > 0 ? size_kb * 1024 : AMS_DEFAULT_HUGE_PAGE_SIZE;
+}
+
+static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
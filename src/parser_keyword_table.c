@@ -0,0 +1,118 @@
+/* Generated by tools/gen_parser_keywords from config/normalization-rules.example. Do not edit. */
+#include "parser_keywords.h"
+
+const unsigned char PARSER_KEYWORD_DISPLACEMENTS[AMS_KEYWORD_BUCKETS] = {
+    1, 11, 4, 0, 16, 15, 0, 0, 1, 24, 0, 10, 22, 0, 10, 2,
+    1, 2, 0, 3, 2, 11, 97, 21, 62, 15, 31, 14, 61, 12, 6, 1};
+
+const ParserKeyword PARSER_KEYWORDS[AMS_KEYWORD_SLOTS] = {
+    [0] = {"RI", 2, AMS_KEYWORD_STATE, "RI"},
+    [1] = {"CT", 2, AMS_KEYWORD_STATE | AMS_KEYWORD_SUFFIX, "CT"},
+    [2] = {"ROAD", 4, AMS_KEYWORD_SUFFIX, "ROAD"},
+    [3] = {"KS", 2, AMS_KEYWORD_STATE, "KS"},
+    [4] = {"STREET", 6, AMS_KEYWORD_SUFFIX, "STREET"},
+    [5] = {"SOUTHWEST", 9, AMS_KEYWORD_DIRECTION, "SW"},
+    [6] = {"ROOM", 4, AMS_KEYWORD_UNIT, "ROOM"},
+    [7] = {"NC", 2, AMS_KEYWORD_STATE, "NC"},
+    [8] = {"VA", 2, AMS_KEYWORD_STATE, "VA"},
+    [9] = {"AR", 2, AMS_KEYWORD_STATE, "AR"},
+    [12] = {"MT", 2, AMS_KEYWORD_STATE, "MT"},
+    [13] = {"AVENUE", 6, AMS_KEYWORD_SUFFIX, "AVENUE"},
+    [15] = {"LN", 2, AMS_KEYWORD_SUFFIX, "LN"},
+    [16] = {"LANE", 4, AMS_KEYWORD_SUFFIX, "LANE"},
+    [17] = {"TER", 3, AMS_KEYWORD_SUFFIX, "TER"},
+    [18] = {"GA", 2, AMS_KEYWORD_STATE, "GA"},
+    [19] = {"MI", 2, AMS_KEYWORD_STATE, "MI"},
+    [20] = {"TERRACE", 7, AMS_KEYWORD_SUFFIX, "TERRACE"},
+    [21] = {"NORTHWEST", 9, AMS_KEYWORD_DIRECTION, "NW"},
+    [22] = {"TX", 2, AMS_KEYWORD_STATE, "TX"},
+    [23] = {"NE", 2, AMS_KEYWORD_STATE | AMS_KEYWORD_DIRECTION, "NE"},
+    [24] = {"IA", 2, AMS_KEYWORD_STATE, "IA"},
+    [25] = {"MO", 2, AMS_KEYWORD_STATE, "MO"},
+    [26] = {"VT", 2, AMS_KEYWORD_STATE, "VT"},
+    [27] = {"KY", 2, AMS_KEYWORD_STATE, "KY"},
+    [28] = {"EAST", 4, AMS_KEYWORD_DIRECTION, "E"},
+    [29] = {"WY", 2, AMS_KEYWORD_STATE, "WY"},
+    [30] = {"IN", 2, AMS_KEYWORD_STATE, "IN"},
+    [31] = {"ME", 2, AMS_KEYWORD_STATE, "ME"},
+    [32] = {"SW", 2, AMS_KEYWORD_DIRECTION, "SW"},
+    [33] = {"RD", 2, AMS_KEYWORD_SUFFIX, "RD"},
+    [35] = {"LOOP", 4, AMS_KEYWORD_SUFFIX, "LOOP"},
+    [37] = {"NORTHEAST", 9, AMS_KEYWORD_DIRECTION, "NE"},
+    [38] = {"N", 1, AMS_KEYWORD_DIRECTION, "N"},
+    [41] = {"DR", 2, AMS_KEYWORD_SUFFIX, "DR"},
+    [42] = {"TRAIL", 5, AMS_KEYWORD_SUFFIX, "TRAIL"},
+    [43] = {"BLVD", 4, AMS_KEYWORD_SUFFIX, "BLVD"},
+    [44] = {"ALLEY", 5, AMS_KEYWORD_SUFFIX, "ALLEY"},
+    [45] = {"#", 1, AMS_KEYWORD_UNIT, "#"},
+    [46] = {"ST", 2, AMS_KEYWORD_SUFFIX, "ST"},
+    [47] = {"FLOOR", 5, AMS_KEYWORD_UNIT, "FLOOR"},
+    [48] = {"WV", 2, AMS_KEYWORD_STATE, "WV"},
+    [49] = {"BEND", 4, AMS_KEYWORD_SUFFIX, "BEND"},
+    [50] = {"AZ", 2, AMS_KEYWORD_STATE, "AZ"},
+    [51] = {"FL", 2, AMS_KEYWORD_STATE | AMS_KEYWORD_UNIT, "FL"},
+    [52] = {"LEVEL", 5, AMS_KEYWORD_UNIT, "LEVEL"},
+    [54] = {"WAY", 3, AMS_KEYWORD_SUFFIX, "WAY"},
+    [56] = {"DRIVE", 5, AMS_KEYWORD_SUFFIX, "DRIVE"},
+    [57] = {"CA", 2, AMS_KEYWORD_STATE, "CA"},
+    [58] = {"WEST", 4, AMS_KEYWORD_DIRECTION, "W"},
+    [59] = {"W", 1, AMS_KEYWORD_DIRECTION, "W"},
+    [60] = {"SUITE", 5, AMS_KEYWORD_UNIT, "SUITE"},
+    [61] = {"TN", 2, AMS_KEYWORD_STATE, "TN"},
+    [62] = {"LA", 2, AMS_KEYWORD_STATE, "LA"},
+    [63] = {"OR", 2, AMS_KEYWORD_STATE, "OR"},
+    [64] = {"SOUTH", 5, AMS_KEYWORD_DIRECTION, "S"},
+    [65] = {"FWY", 3, AMS_KEYWORD_SUFFIX, "FWY"},
+    [66] = {"TRL", 3, AMS_KEYWORD_SUFFIX, "TRL"},
+    [67] = {"BOULEVARD", 9, AMS_KEYWORD_SUFFIX, "BOULEVARD"},
+    [68] = {"WI", 2, AMS_KEYWORD_STATE, "WI"},
+    [69] = {"AK", 2, AMS_KEYWORD_STATE, "AK"},
+    [71] = {"SD", 2, AMS_KEYWORD_STATE, "SD"},
+    [72] = {"NW", 2, AMS_KEYWORD_DIRECTION, "NW"},
+    [73] = {"E", 1, AMS_KEYWORD_DIRECTION, "E"},
+    [74] = {"STE", 3, AMS_KEYWORD_UNIT, "STE"},
+    [75] = {"PL", 2, AMS_KEYWORD_SUFFIX, "PL"},
+    [76] = {"CO", 2, AMS_KEYWORD_STATE, "CO"},
+    [77] = {"PKWY", 4, AMS_KEYWORD_SUFFIX, "PKWY"},
+    [78] = {"PARKWAY", 7, AMS_KEYWORD_SUFFIX, "PARKWAY"},
+    [79] = {"IL", 2, AMS_KEYWORD_STATE, "IL"},
+    [81] = {"DE", 2, AMS_KEYWORD_STATE, "DE"},
+    [83] = {"SE", 2, AMS_KEYWORD_DIRECTION, "SE"},
+    [84] = {"FREEWAY", 7, AMS_KEYWORD_SUFFIX, "FREEWAY"},
+    [85] = {"MS", 2, AMS_KEYWORD_STATE, "MS"},
+    [87] = {"ALLY", 4, AMS_KEYWORD_SUFFIX, "ALLY"},
+    [89] = {"NJ", 2, AMS_KEYWORD_STATE, "NJ"},
+    [90] = {"MN", 2, AMS_KEYWORD_STATE, "MN"},
+    [91] = {"ID", 2, AMS_KEYWORD_STATE, "ID"},
+    [92] = {"S", 1, AMS_KEYWORD_DIRECTION, "S"},
+    [93] = {"MD", 2, AMS_KEYWORD_STATE, "MD"},
+    [94] = {"CIR", 3, AMS_KEYWORD_SUFFIX, "CIR"},
+    [95] = {"PLACE", 5, AMS_KEYWORD_SUFFIX, "PLACE"},
+    [96] = {"NY", 2, AMS_KEYWORD_STATE, "NY"},
+    [97] = {"NM", 2, AMS_KEYWORD_STATE, "NM"},
+    [98] = {"OH", 2, AMS_KEYWORD_STATE, "OH"},
+    [99] = {"HIGHWAY", 7, AMS_KEYWORD_SUFFIX, "HIGHWAY"},
+    [100] = {"HWY", 3, AMS_KEYWORD_SUFFIX, "HWY"},
+    [101] = {"NV", 2, AMS_KEYWORD_STATE, "NV"},
+    [102] = {"CIRCLE", 6, AMS_KEYWORD_SUFFIX, "CIRCLE"},
+    [103] = {"NORTH", 5, AMS_KEYWORD_DIRECTION, "N"},
+    [104] = {"RM", 2, AMS_KEYWORD_UNIT, "RM"},
+    [105] = {"SOUTHEAST", 9, AMS_KEYWORD_DIRECTION, "SE"},
+    [106] = {"COURT", 5, AMS_KEYWORD_SUFFIX, "COURT"},
+    [107] = {"PA", 2, AMS_KEYWORD_STATE, "PA"},
+    [108] = {"HI", 2, AMS_KEYWORD_STATE, "HI"},
+    [109] = {"BLDG", 4, AMS_KEYWORD_UNIT, "BLDG"},
+    [110] = {"BUILDING", 8, AMS_KEYWORD_UNIT, "BUILDING"},
+    [111] = {"ND", 2, AMS_KEYWORD_STATE, "ND"},
+    [112] = {"DC", 2, AMS_KEYWORD_STATE, "DC"},
+    [113] = {"APT", 3, AMS_KEYWORD_UNIT, "APT"},
+    [114] = {"AL", 2, AMS_KEYWORD_STATE, "AL"},
+    [115] = {"MA", 2, AMS_KEYWORD_STATE, "MA"},
+    [116] = {"AVE", 3, AMS_KEYWORD_SUFFIX, "AVE"},
+    [117] = {"UNIT", 4, AMS_KEYWORD_UNIT, "UNIT"},
+    [118] = {"UT", 2, AMS_KEYWORD_STATE, "UT"},
+    [122] = {"SC", 2, AMS_KEYWORD_STATE, "SC"},
+    [124] = {"APARTMENT", 9, AMS_KEYWORD_UNIT, "APARTMENT"},
+    [125] = {"NH", 2, AMS_KEYWORD_STATE, "NH"},
+    [126] = {"OK", 2, AMS_KEYWORD_STATE, "OK"},
+    [127] = {"WA", 2, AMS_KEYWORD_STATE, "WA"}};
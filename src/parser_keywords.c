@@ -0,0 +1,33 @@
+#include "parser_keywords.h"
+
+#include <string.h>
+
+uint32_t parser_keyword_slot(uint64_t hash, unsigned displacement) {
+    return (((uint32_t)(hash >> 32) ^ displacement) * AMS_KEYWORD_MULTIPLIER) >> AMS_KEYWORD_SLOT_SHIFT;
+}
+
+const ParserKeyword *parser_keyword_find(const char *text, size_t length) {
+    if (text == NULL || length == 0 || length > AMS_KEYWORD_MAX_LENGTH) {
+        return NULL;
+    }
+    uint64_t hash = ams_hash_bytes(0, text, length);
+    unsigned displacement = PARSER_KEYWORD_DISPLACEMENTS[hash & (AMS_KEYWORD_BUCKETS - 1)];
+    const ParserKeyword *keyword = &PARSER_KEYWORDS[parser_keyword_slot(hash, displacement)];
+    if (keyword->text == NULL || keyword->length != length || memcmp(keyword->text, text, length) != 0) {
+        return NULL;
+    }
+    return keyword;
+}
+
+int parser_keywords_verify(void) {
+    for (size_t slot = 0; slot < AMS_KEYWORD_SLOTS; ++slot) {
+        const ParserKeyword *keyword = &PARSER_KEYWORDS[slot];
+        if (keyword->text == NULL) {
+            continue;
+        }
+        if (keyword->length != strlen(keyword->text) || parser_keyword_find(keyword->text, keyword->length) != keyword) {
+            return -1;
+        }
+    }
+    return 0;
+}
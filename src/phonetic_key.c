@@ -0,0 +1,174 @@
+#include "phonetic_key.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#define AMS_PHONETIC_MAX_LETTERS 128
+
+static int is_vowel(char value);
+static char letter_at(const char *letters, size_t length, size_t index);
+static int emit(char *key, size_t key_size, size_t *key_length, const char *code);
+
+size_t phonetic_key(const char *value, char *key, size_t key_size) {
+    if (key == NULL || key_size == 0) {
+        return 0;
+    }
+    key[0] = '\0';
+    if (value == NULL) {
+        return 0;
+    }
+
+    char letters[AMS_PHONETIC_MAX_LETTERS];
+    size_t length = 0;
+    for (size_t i = 0; value[i] != '\0' && length + 1 < sizeof(letters); ++i) {
+        unsigned char c = (unsigned char)value[i];
+        if (isalnum(c)) {
+            letters[length++] = (char)toupper(c);
+        }
+    }
+    letters[length] = '\0';
+
+    size_t start = 0;
+    if (strncmp(letters, "MAC", 3) == 0) {
+        letters[1] = 'M';
+        start = 1;
+    } else if (strncmp(letters, "AE", 2) == 0 || strncmp(letters, "GN", 2) == 0 ||
+               strncmp(letters, "KN", 2) == 0 || strncmp(letters, "PN", 2) == 0 ||
+               strncmp(letters, "WR", 2) == 0) {
+        start = 1;
+    }
+
+    size_t key_length = 0;
+    for (size_t i = start; i < length; ++i) {
+        char c = letters[i];
+        char prev = i > start ? letters[i - 1] : '\0';
+        char next = letter_at(letters, length, i + 1);
+        char after = letter_at(letters, length, i + 2);
+        char literal[2] = {c, '\0'};
+        const char *code = NULL;
+
+        if (c == prev && c != 'C' && !isdigit((unsigned char)c)) {
+            continue;
+        }
+        if (isdigit((unsigned char)c)) {
+            if (emit(key, key_size, &key_length, literal) != 0) {
+                break;
+            }
+            continue;
+        }
+
+        switch (c) {
+        case 'A':
+        case 'E':
+        case 'I':
+        case 'O':
+        case 'U':
+            code = i == start ? "A" : NULL;
+            break;
+        case 'B':
+            code = (prev == 'M' && next == '\0') ? NULL : "P";
+            break;
+        case 'C':
+            if (next == 'I' && after == 'A') {
+                code = "X";
+            } else if (next == 'H') {
+                code = prev == 'S' ? "K" : "X";
+                ++i;
+            } else if (next == 'I' || next == 'E' || next == 'Y') {
+                code = prev == 'S' ? NULL : "S";
+            } else {
+                code = "K";
+            }
+            break;
+        case 'D':
+            code = (next == 'G' && (after == 'E' || after == 'I' || after == 'Y')) ? "J" : "T";
+            break;
+        case 'G':
+            if (next == 'H' && after != '\0' && !is_vowel(after)) {
+                code = NULL;
+            } else if (next == 'N' && (after == '\0' || (after == 'E' && letter_at(letters, length, i + 3) == 'D'))) {
+                code = NULL;
+            } else if (prev == 'D' && (next == 'E' || next == 'I' || next == 'Y')) {
+                code = NULL;
+            } else if (next == 'I' || next == 'E' || next == 'Y') {
+                code = "J";
+            } else {
+                code = "K";
+            }
+            break;
+        case 'H':
+            if (is_vowel(next) && !(prev == 'C' || prev == 'S' || prev == 'P' || prev == 'T' || prev == 'G')) {
+                code = "H";
+            }
+            break;
+        case 'K':
+            code = prev == 'C' ? NULL : "K";
+            break;
+        case 'P':
+            code = next == 'H' ? "F" : "P";
+            break;
+        case 'Q':
+            code = "K";
+            break;
+        case 'S':
+            if (next == 'H' || (next == 'I' && (after == 'O' || after == 'A'))) {
+                code = "X";
+            } else {
+                code = "S";
+            }
+            break;
+        case 'T':
+            if (next == 'I' && (after == 'O' || after == 'A')) {
+                code = "X";
+            } else if (next == 'H') {
+                code = "0";
+            } else if (next == 'C' && after == 'H') {
+                code = NULL;
+            } else {
+                code = "T";
+            }
+            break;
+        case 'V':
+            code = "F";
+            break;
+        case 'W':
+        case 'Y':
+            code = is_vowel(next) ? (c == 'W' ? "W" : "Y") : NULL;
+            break;
+        case 'X':
+            code = i == start ? "S" : "KS";
+            break;
+        case 'Z':
+            code = "S";
+            break;
+        default:
+            code = literal;
+            break;
+        }
+
+        if (code != NULL && emit(key, key_size, &key_length, code) != 0) {
+            break;
+        }
+    }
+
+    return key_length;
+}
+
+static int is_vowel(char value) {
+    return value == 'A' || value == 'E' || value == 'I' || value == 'O' || value == 'U';
+}
+
+static char letter_at(const char *letters, size_t length, size_t index) {
+    return index < length ? letters[index] : '\0';
+}
+
+static int emit(char *key, size_t key_size, size_t *key_length, const char *code) {
+    size_t code_length = strlen(code);
+    if (*key_length + code_length >= key_size) {
+        return -1;
+    }
+    memcpy(key + *key_length, code, code_length);
+    *key_length += code_length;
+    key[*key_length] = '\0';
+    return 0;
+}
@@ -0,0 +1,280 @@
+#include "text_rewriter.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define AMS_REWRITE_NONE UINT32_MAX
+
+static int rewriter_copy_rules(TextRewriter *rewriter, const RewriteRule *rules, size_t count);
+static int rewriter_build_automaton(TextRewriter *rewriter);
+static void rewriter_emit(char *out, size_t out_size, size_t *written, const char *text, size_t length);
+
+void text_rewriter_init(TextRewriter *rewriter) {
+    if (rewriter == NULL) {
+        return;
+    }
+    memset(rewriter, 0, sizeof(*rewriter));
+}
+
+void text_rewriter_free(TextRewriter *rewriter) {
+    if (rewriter == NULL) {
+        return;
+    }
+    free(rewriter->arena);
+    free(rewriter->needle_offsets);
+    free(rewriter->needle_lengths);
+    free(rewriter->consumed_lengths);
+    free(rewriter->replacement_offsets);
+    free(rewriter->replacement_lengths);
+    free(rewriter->transitions);
+    free(rewriter->outputs);
+    free(rewriter->output_links);
+    memset(rewriter, 0, sizeof(*rewriter));
+}
+
+int text_rewriter_build(TextRewriter *rewriter, const RewriteRule *rules, size_t count) {
+    if (rewriter == NULL || (rules == NULL && count > 0)) {
+        return -1;
+    }
+    text_rewriter_free(rewriter);
+    for (size_t i = 0; i < count; ++i) {
+        if (rules[i].needle == NULL || rules[i].replacement == NULL) {
+            return -1;
+        }
+        size_t needle_length = strlen(rules[i].needle);
+        if (needle_length == 0 || needle_length > AMS_REWRITE_MAX_NEEDLE) {
+            return -1;
+        }
+    }
+    if (rewriter_copy_rules(rewriter, rules, count) != 0 || rewriter_build_automaton(rewriter) != 0) {
+        text_rewriter_free(rewriter);
+        return -1;
+    }
+    return 0;
+}
+
+size_t text_rewriter_apply(
+    const TextRewriter *rewriter,
+    const char *text,
+    size_t length,
+    char *out,
+    size_t out_size) {
+    if (out == NULL || out_size == 0) {
+        return 0;
+    }
+    out[0] = '\0';
+    if (text == NULL) {
+        return 0;
+    }
+
+    size_t written = 0;
+    if (rewriter == NULL || rewriter->rule_count == 0) {
+        rewriter_emit(out, out_size, &written, text, length);
+        return written;
+    }
+
+    int32_t pending[AMS_REWRITE_MAX_NEEDLE];
+    for (size_t i = 0; i < AMS_REWRITE_MAX_NEEDLE; ++i) {
+        pending[i] = -1;
+    }
+
+    size_t window = rewriter->max_needle_length;
+    uint32_t state = 0;
+    size_t next_free = 0;
+    for (size_t i = 0; i < length + window - 1; ++i) {
+        if (i < length) {
+            uint8_t byte_class = rewriter->byte_classes[(unsigned char)text[i]];
+            state = rewriter->transitions[(size_t)state * rewriter->class_count + byte_class];
+            uint32_t match = rewriter->outputs[state] >= 0 ? state : rewriter->output_links[state];
+            while (match != AMS_REWRITE_NONE) {
+                int32_t rule = rewriter->outputs[match];
+                size_t start = i + 1 - rewriter->needle_lengths[rule];
+                int32_t *slot = &pending[start % AMS_REWRITE_MAX_NEEDLE];
+                if (*slot < 0 || rewriter->needle_lengths[*slot] < rewriter->needle_lengths[rule]) {
+                    *slot = rule;
+                }
+                match = rewriter->output_links[match];
+            }
+        }
+
+        if (i + 1 < window) {
+            continue;
+        }
+        size_t position = i + 1 - window;
+        int32_t *slot = &pending[position % AMS_REWRITE_MAX_NEEDLE];
+        int32_t rule = *slot;
+        *slot = -1;
+        if (position < next_free) {
+            continue;
+        }
+        if (rule < 0) {
+            rewriter_emit(out, out_size, &written, text + position, 1);
+            next_free = position + 1;
+            continue;
+        }
+        size_t consumed = rewriter->consumed_lengths[rule];
+        size_t replacement_length = rewriter->replacement_lengths[rule];
+        if (written + replacement_length < out_size) {
+            rewriter_emit(
+                out,
+                out_size,
+                &written,
+                rewriter->arena + rewriter->replacement_offsets[rule],
+                replacement_length);
+        } else {
+            rewriter_emit(out, out_size, &written, text + position, consumed);
+        }
+        next_free = position + consumed;
+    }
+    return written;
+}
+
+static int rewriter_copy_rules(TextRewriter *rewriter, const RewriteRule *rules, size_t count) {
+    size_t arena_length = 0;
+    for (size_t i = 0; i < count; ++i) {
+        arena_length += strlen(rules[i].needle) + strlen(rules[i].replacement) + 2;
+    }
+    if (arena_length > UINT32_MAX) {
+        return -1;
+    }
+
+    size_t allocation = count > 0 ? count : 1;
+    rewriter->arena = malloc(arena_length > 0 ? arena_length : 1);
+    rewriter->needle_offsets = malloc(allocation * sizeof(uint32_t));
+    rewriter->needle_lengths = malloc(allocation * sizeof(uint32_t));
+    rewriter->consumed_lengths = malloc(allocation * sizeof(uint32_t));
+    rewriter->replacement_offsets = malloc(allocation * sizeof(uint32_t));
+    rewriter->replacement_lengths = malloc(allocation * sizeof(uint32_t));
+    if (rewriter->arena == NULL || rewriter->needle_offsets == NULL || rewriter->needle_lengths == NULL ||
+        rewriter->consumed_lengths == NULL || rewriter->replacement_offsets == NULL ||
+        rewriter->replacement_lengths == NULL) {
+        return -1;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t needle_length = strlen(rules[i].needle);
+        size_t replacement_length = strlen(rules[i].replacement);
+        memcpy(rewriter->arena + offset, rules[i].needle, needle_length + 1);
+        rewriter->needle_offsets[i] = (uint32_t)offset;
+        rewriter->needle_lengths[i] = (uint32_t)needle_length;
+        offset += needle_length + 1;
+        memcpy(rewriter->arena + offset, rules[i].replacement, replacement_length + 1);
+        rewriter->replacement_offsets[i] = (uint32_t)offset;
+        offset += replacement_length + 1;
+
+        if (needle_length > 1 && replacement_length > 0 && rules[i].needle[needle_length - 1] == ' ' &&
+            rules[i].replacement[replacement_length - 1] == ' ') {
+            --needle_length;
+            --replacement_length;
+        }
+        rewriter->consumed_lengths[i] = (uint32_t)needle_length;
+        if (rewriter->needle_lengths[i] > rewriter->max_needle_length) {
+            rewriter->max_needle_length = rewriter->needle_lengths[i];
+        }
+        rewriter->replacement_lengths[i] = (uint32_t)replacement_length;
+    }
+    rewriter->rule_count = count;
+    return 0;
+}
+
+static int rewriter_build_automaton(TextRewriter *rewriter) {
+    memset(rewriter->byte_classes, 0, sizeof(rewriter->byte_classes));
+    size_t class_count = 1;
+    size_t max_states = 1;
+    for (size_t i = 0; i < rewriter->rule_count; ++i) {
+        const unsigned char *needle = (const unsigned char *)(rewriter->arena + rewriter->needle_offsets[i]);
+        for (size_t j = 0; j < rewriter->needle_lengths[i]; ++j) {
+            if (rewriter->byte_classes[needle[j]] == 0) {
+                if (class_count > UINT8_MAX) {
+                    return -1;
+                }
+                rewriter->byte_classes[needle[j]] = (uint8_t)class_count++;
+            }
+        }
+        max_states += rewriter->needle_lengths[i];
+    }
+    if (max_states >= AMS_REWRITE_NONE) {
+        return -1;
+    }
+
+    rewriter->class_count = class_count;
+    rewriter->transitions = malloc(max_states * class_count * sizeof(uint32_t));
+    rewriter->outputs = malloc(max_states * sizeof(int32_t));
+    rewriter->output_links = malloc(max_states * sizeof(uint32_t));
+    uint32_t *failures = malloc(max_states * sizeof(uint32_t));
+    uint32_t *queue = malloc(max_states * sizeof(uint32_t));
+    if (rewriter->transitions == NULL || rewriter->outputs == NULL || rewriter->output_links == NULL ||
+        failures == NULL || queue == NULL) {
+        free(failures);
+        free(queue);
+        return -1;
+    }
+    for (size_t i = 0; i < max_states * class_count; ++i) {
+        rewriter->transitions[i] = AMS_REWRITE_NONE;
+    }
+    for (size_t i = 0; i < max_states; ++i) {
+        rewriter->outputs[i] = -1;
+        rewriter->output_links[i] = AMS_REWRITE_NONE;
+    }
+
+    size_t state_count = 1;
+    for (size_t i = 0; i < rewriter->rule_count; ++i) {
+        const unsigned char *needle = (const unsigned char *)(rewriter->arena + rewriter->needle_offsets[i]);
+        uint32_t state = 0;
+        for (size_t j = 0; j < rewriter->needle_lengths[i]; ++j) {
+            uint32_t *next = &rewriter->transitions[(size_t)state * class_count + rewriter->byte_classes[needle[j]]];
+            if (*next == AMS_REWRITE_NONE) {
+                *next = (uint32_t)state_count++;
+            }
+            state = *next;
+        }
+        if (rewriter->outputs[state] < 0) {
+            rewriter->outputs[state] = (int32_t)i;
+        }
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+    for (size_t c = 0; c < class_count; ++c) {
+        uint32_t *next = &rewriter->transitions[c];
+        if (*next == AMS_REWRITE_NONE) {
+            *next = 0;
+        } else {
+            failures[*next] = 0;
+            queue[tail++] = *next;
+        }
+    }
+    while (head < tail) {
+        uint32_t state = queue[head++];
+        uint32_t *row = &rewriter->transitions[(size_t)state * class_count];
+        const uint32_t *fallback = &rewriter->transitions[(size_t)failures[state] * class_count];
+        for (size_t c = 0; c < class_count; ++c) {
+            if (row[c] == AMS_REWRITE_NONE) {
+                row[c] = fallback[c];
+                continue;
+            }
+            uint32_t child = row[c];
+            uint32_t failure = fallback[c];
+            failures[child] = failure;
+            rewriter->output_links[child] =
+                rewriter->outputs[failure] >= 0 ? failure : rewriter->output_links[failure];
+            queue[tail++] = child;
+        }
+    }
+    free(failures);
+    free(queue);
+
+    rewriter->state_count = state_count;
+    return 0;
+}
+
+static void rewriter_emit(char *out, size_t out_size, size_t *written, const char *text, size_t length) {
+    size_t available = out_size - 1 - *written;
+    if (length > available) {
+        length = available;
+    }
+    memcpy(out + *written, text, length);
+    *written += length;
+    out[*written] = '\0';
+}
@@ -0,0 +1,168 @@
+#include "parser_keywords.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define AMS_KEYWORD_MAX_DISPLACEMENT 256
+
+typedef struct {
+    const ParserKeyword *keywords[AMS_KEYWORD_SLOTS];
+    uint64_t hashes[AMS_KEYWORD_SLOTS];
+    size_t count;
+} KeywordBucket;
+
+static int place_buckets(
+    KeywordBucket *buckets,
+    unsigned char *displacements,
+    const ParserKeyword **slots);
+static int place_bucket(const KeywordBucket *bucket, const ParserKeyword **slots, unsigned *displacement_out);
+static void print_kinds(unsigned kinds);
+static void print_table(const char *source, const unsigned char *displacements, const ParserKeyword **slots);
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s RULES_FILE\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    NormalizationRules rules;
+    normalization_rules_init(&rules);
+    char error[512];
+    if (normalization_rules_load(&rules, argv[1], error, sizeof(error)) != 0) {
+        fprintf(stderr, "Unable to load normalization rules: %s\n", error);
+        return EXIT_FAILURE;
+    }
+    if (rules.keyword_count > AMS_KEYWORD_SLOTS) {
+        fprintf(stderr, "%zu keywords do not fit in %d slots\n", rules.keyword_count, AMS_KEYWORD_SLOTS);
+        normalization_rules_free(&rules);
+        return EXIT_FAILURE;
+    }
+
+    KeywordBucket buckets[AMS_KEYWORD_BUCKETS];
+    memset(buckets, 0, sizeof(buckets));
+    for (size_t i = 0; i < rules.keyword_count; ++i) {
+        const ParserKeyword *keyword = &rules.keywords[i];
+        if (keyword->length > AMS_KEYWORD_MAX_LENGTH) {
+            fprintf(
+                stderr,
+                "Keyword %s is longer than %d characters\n",
+                keyword->text,
+                AMS_KEYWORD_MAX_LENGTH);
+            normalization_rules_free(&rules);
+            return EXIT_FAILURE;
+        }
+        uint64_t hash = ams_hash_bytes(0, keyword->text, keyword->length);
+        KeywordBucket *bucket = &buckets[hash & (AMS_KEYWORD_BUCKETS - 1)];
+        bucket->keywords[bucket->count] = keyword;
+        bucket->hashes[bucket->count] = hash;
+        ++bucket->count;
+    }
+
+    unsigned char displacements[AMS_KEYWORD_BUCKETS];
+    const ParserKeyword *slots[AMS_KEYWORD_SLOTS];
+    if (place_buckets(buckets, displacements, slots) != 0) {
+        normalization_rules_free(&rules);
+        return EXIT_FAILURE;
+    }
+    print_table(argv[1], displacements, slots);
+    normalization_rules_free(&rules);
+    return EXIT_SUCCESS;
+}
+
+static int place_buckets(
+    KeywordBucket *buckets,
+    unsigned char *displacements,
+    const ParserKeyword **slots) {
+    memset(displacements, 0, AMS_KEYWORD_BUCKETS);
+    memset(slots, 0, AMS_KEYWORD_SLOTS * sizeof(*slots));
+
+    int placed[AMS_KEYWORD_BUCKETS] = {0};
+    for (;;) {
+        size_t largest = AMS_KEYWORD_BUCKETS;
+        for (size_t b = 0; b < AMS_KEYWORD_BUCKETS; ++b) {
+            if (!placed[b] && buckets[b].count > 0 &&
+                (largest == AMS_KEYWORD_BUCKETS || buckets[b].count > buckets[largest].count)) {
+                largest = b;
+            }
+        }
+        if (largest == AMS_KEYWORD_BUCKETS) {
+            return 0;
+        }
+
+        unsigned displacement = 0;
+        if (place_bucket(&buckets[largest], slots, &displacement) != 0) {
+            fprintf(stderr, "Unable to place keyword bucket %zu without collisions\n", largest);
+            return -1;
+        }
+        const KeywordBucket *bucket = &buckets[largest];
+        for (size_t i = 0; i < bucket->count; ++i) {
+            slots[parser_keyword_slot(bucket->hashes[i], displacement)] = bucket->keywords[i];
+        }
+        displacements[largest] = (unsigned char)displacement;
+        placed[largest] = 1;
+    }
+}
+
+static int place_bucket(const KeywordBucket *bucket, const ParserKeyword **slots, unsigned *displacement_out) {
+    for (unsigned displacement = 0; displacement < AMS_KEYWORD_MAX_DISPLACEMENT; ++displacement) {
+        int taken[AMS_KEYWORD_SLOTS] = {0};
+        int fits = 1;
+        for (size_t i = 0; i < bucket->count && fits; ++i) {
+            uint32_t slot = parser_keyword_slot(bucket->hashes[i], displacement);
+            fits = slots[slot] == NULL && !taken[slot];
+            taken[slot] = 1;
+        }
+        if (fits) {
+            *displacement_out = displacement;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static void print_kinds(unsigned kinds) {
+    static const struct {
+        unsigned kind;
+        const char *name;
+    } names[] = {
+        {AMS_KEYWORD_STATE, "AMS_KEYWORD_STATE"},
+        {AMS_KEYWORD_DIRECTION, "AMS_KEYWORD_DIRECTION"},
+        {AMS_KEYWORD_SUFFIX, "AMS_KEYWORD_SUFFIX"},
+        {AMS_KEYWORD_UNIT, "AMS_KEYWORD_UNIT"}};
+    const char *separator = "";
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        if (kinds & names[i].kind) {
+            printf("%s%s", separator, names[i].name);
+            separator = " | ";
+        }
+    }
+}
+
+static void print_table(const char *source, const unsigned char *displacements, const ParserKeyword **slots) {
+    printf("/* Generated by tools/gen_parser_keywords from %s. Do not edit. */\n", source);
+    printf("#include \"parser_keywords.h\"\n\n");
+
+    printf("const unsigned char PARSER_KEYWORD_DISPLACEMENTS[AMS_KEYWORD_BUCKETS] = {");
+    for (size_t b = 0; b < AMS_KEYWORD_BUCKETS; ++b) {
+        printf("%s%u", b % 16 == 0 ? "\n    " : " ", displacements[b]);
+        if (b + 1 < AMS_KEYWORD_BUCKETS) {
+            printf(",");
+        }
+    }
+    printf("};\n\n");
+
+    printf("const ParserKeyword PARSER_KEYWORDS[AMS_KEYWORD_SLOTS] = {");
+    const char *separator = "\n";
+    for (size_t slot = 0; slot < AMS_KEYWORD_SLOTS; ++slot) {
+        const ParserKeyword *keyword = slots[slot];
+        if (keyword == NULL) {
+            continue;
+        }
+        printf("%s    [%zu] = {\"%s\", %u, ", separator, slot, keyword->text, (unsigned)keyword->length);
+        print_kinds(keyword->kinds);
+        printf(", \"%s\"}", keyword->canonical);
+        separator = ",\n";
+    }
+    printf("};\n");
+}